@@ -0,0 +1,282 @@
+/**
+ * @file AutoDepq.h
+ * @brief 依照工作負載自動選擇實作的 double-ended priority queue
+ */
+#ifndef AUTODEPQ_H
+#define AUTODEPQ_H
+
+#include "Depq.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include <cmath>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/// 工作負載：heap 的大小，以及操作中 popMin、popMax 各佔的比例（其餘為 push）
+struct DepqWorkload {
+    size_t size = 0;
+    double minShare = 0;
+    double maxShare = 0;
+};
+
+/// AutoDepq 預設的 policy
+struct AutoDepqPolicy {
+    /// 候選的實作，每一個都要滿足 Depq_Trait::isMigratable
+    template<typename T>
+    using Backends = std::variant<BasicMinMaxHeap<T>, BasicDeap<T>>;
+
+    /// 校準時每個實作執行幾次操作
+    static constexpr size_t CALIBRATION_OPS = 1 << 12;
+    /// 每隔幾次操作檢查一次工作負載有沒有改變
+    static constexpr size_t WINDOW = 1 << 15;
+    /// popMin、popMax 的比例和校準時相差（合計）超過多少就重新校準
+    static constexpr double DRIFT = 0.25;
+    /// 大小變成校準時的幾倍（或幾分之一）就重新校準
+    static constexpr double GROWTH = 4;
+    /// recalibrate() 最多從目前的內容取幾個元素當作 sample
+    static constexpr size_t SAMPLE = 1 << 14;
+
+    /// @brief 量測 run 的成本
+    /// @tparam Heap - 正在量測的實作
+    /// @return 成本，越小越好（這裡是秒數）
+    template<typename Heap, typename Func>
+    static double cost(const DepqWorkload&, Func&& run) { return Benchmark::measure(run); }
+};
+
+/**
+ * @brief 在 Policy 提供的實作中，自動選擇目前的工作負載下最快的一個
+ * @tparam T - 元素的型別
+ * @tparam Policy - 提供候選的實作、校準和切換的參數，參考 AutoDepqPolicy
+ * @details
+ * # 校準
+ * calibrate() 把 sample 放進每一個候選的實作，依照工作負載的比例執行 CALIBRATION_OPS 次相同的操作，
+ * 用 Policy::cost 量測（預設是 Benchmark::measure 的秒數），選擇成本最低的一個。
+ *
+ * # 線上切換
+ * 每 WINDOW 次操作統計一次 popMin、popMax 的比例和目前的大小，和上次校準時相差太多時只會設定 needsRecalibration()，
+ * push、pop 本身仍然是原本實作的成本。呼叫端在適合停頓的時候呼叫 recalibrate()，
+ * 從目前的內容平均取出最多 SAMPLE 個元素重新校準，成本和 heap 的大小無關（取 sample 的掃描除外）。
+ * 選到不同的實作時，用新實作的範圍建構子從舊實作的 begin()、end() 建立，O(n)，再丟掉舊的。
+ */
+template<typename T, typename Policy = AutoDepqPolicy>
+class AutoDepq {
+public:
+    typedef T value_type;
+    typedef typename Policy::template Backends<T> Variant;
+
+private:
+    template<typename V> struct AllMigratable;
+    template<typename... H> struct AllMigratable<std::variant<H...>> : std::bool_constant<(Depq_Trait::isMigratable<H> && ...)> {};
+    static_assert(AllMigratable<Variant>::value, "AutoDepq - every backend must satisfy Depq_Trait::isMigratable");
+
+    /// calibrate() 的操作種類
+    enum Op : uint8_t { PUSH, POP_MIN, POP_MAX };
+
+    Variant m_heap;
+
+    /// 上次校準時的工作負載
+    DepqWorkload m_calibrated;
+    bool m_hasCalibrated = false;
+
+    /// 最近一個 window 觀察到的工作負載，以及它是否需要重新校準
+    DepqWorkload m_observed;
+    bool m_pending = false;
+
+    /// 這一個 window 內各種操作的次數
+    size_t m_pushes = 0;
+    size_t m_popMins = 0;
+    size_t m_popMaxes = 0;
+
+    size_t m_migrations = 0;
+
+public:
+    /// 建立空的 AutoDepq，一開始使用第一個實作
+    AutoDepq() = default;
+
+    /// @brief 用第一個實作從 [first, last) 建立 AutoDepq
+    /// @tparam InputIt - 滿足 input iterator
+    template<typename InputIt>
+    AutoDepq(InputIt first, InputIt last) : m_heap(std::in_place_index<0>, first, last) {}
+
+    /// @brief 插入 value
+    void push(const value_type& value) {
+        std::visit([&](auto& h) { h.push(value); }, m_heap);
+        ++m_pushes;
+        tick();
+    }
+
+    /// @brief 移除最小值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMin() {
+        value_type ret = std::visit([](auto& h) -> value_type { return h.popMin(); }, m_heap);
+        ++m_popMins;
+        tick();
+        return ret;
+    }
+
+    /// @brief 移除最大值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMax() {
+        value_type ret = std::visit([](auto& h) -> value_type { return h.popMax(); }, m_heap);
+        ++m_popMaxes;
+        tick();
+        return ret;
+    }
+
+    /// @brief 回傳最小值，不移除
+    /// @throw std::out_of_range - 如果為空
+    const value_type& peekMin() const {
+        return std::visit([](const auto& h) -> const value_type& { return h.peekMin(); }, m_heap);
+    }
+
+    /// @brief 回傳最大值，不移除
+    /// @throw std::out_of_range - 如果為空
+    const value_type& peekMax() const {
+        return std::visit([](const auto& h) -> const value_type& { return h.peekMax(); }, m_heap);
+    }
+
+    /// 有幾個元素
+    size_t size() const { return std::visit([](const auto& h) -> size_t { return h.size(); }, m_heap); }
+
+    /// 目前使用的實作在 Policy::Backends 中的 index
+    size_t backend() const { return m_heap.index(); }
+
+    /// 切換過幾次實作
+    size_t migrations() const { return m_migrations; }
+
+    /// 上次校準時的工作負載
+    const DepqWorkload& calibrated() const { return m_calibrated; }
+
+    /// 最近一個 window 觀察到的工作負載
+    const DepqWorkload& observed() const { return m_observed; }
+
+    /// 工作負載和上次校準時相差太多（或還沒校準過），應該呼叫 recalibrate()
+    bool needsRecalibration() const { return m_pending; }
+
+    /**
+     * @brief 如果 needsRecalibration()，用目前的內容依觀察到的工作負載重新校準
+     * @details 從目前的內容中平均取出最多 Policy::SAMPLE 個元素當作 sample，所以量測的成本有上限；
+     * 選到不同的實作時仍需要 O(n) 搬移內容。
+     */
+    void recalibrate() {
+        if (!m_pending) return;
+        m_pending = false;
+
+        const size_t n = size();
+        const size_t step = n / Policy::SAMPLE + 1;
+        std::vector<value_type> sample = std::visit([&](const auto& h) {
+            std::vector<value_type> ret;
+            ret.reserve(n / step + 1);
+            size_t i = 0;
+            for (auto it = h.begin(); it != h.end(); ++it, ++i) {
+                if (i % step == 0) ret.push_back(*it);
+            }
+            return ret;
+        }, m_heap);
+
+        calibrate(sample, m_observed);
+        if (!sample.empty()) m_calibrated.size = n;
+    }
+
+    /**
+     * @brief 用 sample 當作內容，依 workload 的比例量測每一個實作，切換到最快的一個
+     * @param sample - 代表性的內容，大小應該接近預期的大小。為空時不做任何事
+     * @param workload - 預期的工作負載，只會用到 minShare、maxShare
+     */
+    void calibrate(const std::vector<value_type>& sample, const DepqWorkload& workload) {
+        if (sample.empty()) return;
+
+        migrate(fastest(sample, workload, std::make_index_sequence<std::variant_size_v<Variant>>()));
+
+        m_calibrated = workload;
+        m_calibrated.size = sample.size();
+        m_hasCalibrated = true;
+        m_pending = false;
+    }
+
+private:
+    /// @brief 每 WINDOW 次操作記錄一次工作負載，改變太多就設定 needsRecalibration()，O(1)
+    void tick() {
+        const size_t total = m_pushes + m_popMins + m_popMaxes;
+        if (total < Policy::WINDOW) return;
+
+        m_observed.size = size();
+        m_observed.minShare = double(m_popMins) / total;
+        m_observed.maxShare = double(m_popMaxes) / total;
+        m_pushes = m_popMins = m_popMaxes = 0;
+
+        m_pending = !m_hasCalibrated || drifted(m_observed);
+    }
+
+    /// observed 是否和上次校準時相差太多
+    bool drifted(const DepqWorkload& observed) const {
+        const double mix = std::fabs(observed.minShare - m_calibrated.minShare) + std::fabs(observed.maxShare - m_calibrated.maxShare);
+        return mix > Policy::DRIFT ||
+               double(observed.size) > double(m_calibrated.size) * Policy::GROWTH ||
+               double(observed.size) * Policy::GROWTH < double(m_calibrated.size);
+    }
+
+    /// @brief 量測每一個實作，回傳成本最低的 index
+    template<size_t... I>
+    static size_t fastest(const std::vector<value_type>& sample, const DepqWorkload& workload, std::index_sequence<I...>) {
+        // 所有實作執行同一串操作
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<Op> ops(Policy::CALIBRATION_OPS);
+        for (Op& op : ops) {
+            const double r = dist(rng);
+            op = r < workload.minShare ? POP_MIN : r < workload.minShare + workload.maxShare ? POP_MAX : PUSH;
+        }
+
+        const double costs[] = { cost<std::variant_alternative_t<I, Variant>>(sample, ops, workload)... };
+
+        size_t best = 0;
+        for (size_t i = 1; i < sizeof...(I); ++i) {
+            if (costs[i] < costs[best]) best = i;
+        }
+        return best;
+    }
+
+    /// @brief 用 sample 建立 Heap，量測執行 ops 的成本。push 的值依序從 sample 中取，heap 為空時的 pop 改成 push
+    template<typename Heap>
+    static double cost(const std::vector<value_type>& sample, const std::vector<Op>& ops, const DepqWorkload& workload) {
+        Heap heap(sample.data(), sample.data() + sample.size());
+        size_t next = 0;
+
+        return Policy::template cost<Heap>(workload, [&] {
+            for (Op op : ops) {
+                if (op == PUSH || heap.size() == 0) {
+                    heap.push(sample[next]);
+                    if (++next == sample.size()) next = 0;
+                }
+                else if (op == POP_MIN) heap.popMin();
+                else                    heap.popMax();
+            }
+        });
+    }
+
+    /// @brief 切換到 Policy::Backends 中的第 index 個實作，用它的範圍建構子搬移目前的內容
+    template<size_t I = 0>
+    void migrate(size_t index) {
+        if constexpr (I < std::variant_size_v<Variant>) {
+            if (I != index) {
+                migrate<I + 1>(index);
+                return;
+            }
+            if (m_heap.index() == I) return;
+
+            typedef std::variant_alternative_t<I, Variant> Target;
+            Target next = std::visit([](const auto& h) { return Target(h.begin(), h.end()); }, m_heap);
+            m_heap.template emplace<I>(std::move(next));
+            ++m_migrations;
+        }
+    }
+};
+
+#endif // AUTODEPQ_H
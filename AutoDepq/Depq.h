@@ -0,0 +1,69 @@
+/**
+ * @file Depq.h
+ * @brief double-ended priority queue 共同的介面，用來在編譯期檢查 MinMaxHeap、Deap 等類別可以互相替換
+ */
+#ifndef DEPQ_H
+#define DEPQ_H
+
+#include <type_traits>
+#include <utility>
+#include <stddef.h>
+
+/**
+ * @brief double-ended priority queue 的介面
+ * @details
+ * isDepq<H>：H 可以當作一般的 double-ended priority queue 使用
+ * - `H::value_type`
+ * - 可以預設建構，也可以從 `[first, last)` 建構
+ * - `push(value)`、`popMin()`、`popMax()`、`peekMin()`、`peekMax()`、`size()`
+ *
+ * MinMaxHeap、Deap、BucketQueue、EdgeHeap、RunLengthHeap、StaticMinMaxHeap 都滿足 isDepq。
+ *
+ * isMigratable<H>：除了 isDepq，還能把內容搬到其他實作（AutoDepq 的候選實作需要滿足）
+ * - `begin()`、`end()` 依內部的順序走訪所有元素，配合範圍建構子（應該是線性時間）就能在不同的實作之間搬移內容
+ *
+ * 目前只有 GenericMinMaxHeap、GenericDeap 滿足 isMigratable。
+ */
+namespace Depq_Trait {
+    template<typename H, typename = void>
+    struct IsDepq : std::false_type {};
+
+    template<typename H>
+    struct IsDepq<H, std::void_t<
+        typename H::value_type,
+        decltype(std::declval<H&>().push(std::declval<const typename H::value_type&>())),
+        decltype(std::declval<H&>().popMin()),
+        decltype(std::declval<H&>().popMax()),
+        decltype(std::declval<const H&>().peekMin()),
+        decltype(std::declval<const H&>().peekMax()),
+        decltype(size_t(std::declval<const H&>().size()))>>
+        : std::bool_constant<std::is_default_constructible<H>::value &&
+                             std::is_constructible<H, const typename H::value_type*, const typename H::value_type*>::value> {};
+
+    template<typename H, typename = void>
+    struct IsMigratable : std::false_type {};
+
+    template<typename H>
+    struct IsMigratable<H, std::void_t<decltype(std::declval<const H&>().begin() != std::declval<const H&>().end())>>
+        : IsDepq<H> {};
+
+    /// H 是否滿足 double-ended priority queue 的介面
+    template<typename H>
+    constexpr bool isDepq = IsDepq<H>::value;
+
+    /// H 是否滿足 double-ended priority queue 的介面，而且可以用 begin()、end() 把內容搬到其他實作
+    template<typename H>
+    constexpr bool isMigratable = IsMigratable<H>::value;
+}
+
+#if defined(__cpp_concepts)
+/// Depq_Trait::isDepq 的 C++20 concept 版本
+template<typename H>
+concept Depq = Depq_Trait::isDepq<H>;
+
+/// Depq_Trait::isMigratable 的 C++20 concept 版本
+template<typename H>
+concept MigratableDepq = Depq_Trait::isMigratable<H>;
+#endif
+
+#endif // DEPQ_H
@@ -0,0 +1,76 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 AutoDepq 和固定使用 MinMaxHeap、Deap 在工作負載改變時的速度
+ */
+#include "AutoDepq.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include <random>
+#include <string>
+#include <vector>
+
+static const size_t N = 1 << 16;         ///< 一開始的元素數量
+static const size_t PHASE_OPS = 1 << 21; ///< 每個階段的操作次數
+
+/// 每個階段中 popMin、popMax 的比例，其餘為 push
+struct Phase {
+    const char* name;
+    double minShare;
+    double maxShare;
+};
+
+static const Phase PHASES[] = {
+    { "push / popMin",          0.5,  0    },
+    { "push / popMax",          0,    0.5  },
+    { "push / popMin / popMax", 0.25, 0.25 },
+};
+
+/// @brief 呼叫端定期讓 AutoDepq 重新校準；其他實作不需要
+template<typename Heap>
+void maintain(Heap&) {}
+
+template<typename T, typename Policy>
+void maintain(AutoDepq<T, Policy>& heap) { heap.recalibrate(); }
+
+/// @brief 依序執行所有階段，每個階段分開計時
+template<typename Heap>
+void run(const char* name, Heap& heap) {
+    std::mt19937 rng(1);
+    for (size_t i = 0; i < N; ++i) heap.push(static_cast<int>(rng()));
+
+    for (const Phase& p : PHASES) {
+        std::uniform_real_distribution<double> dist(0, 1);
+        std::vector<double> rolls(PHASE_OPS);
+        for (double& r : rolls) r = dist(rng);
+
+        long long sum = 0;
+        double seconds = Benchmark::measure([&] {
+            for (size_t i = 0; i < PHASE_OPS; ++i) {
+                const double r = rolls[i];
+                if ((i & 0xFFFF) == 0) maintain(heap);
+                if (r < p.minShare)                   sum += heap.popMin();
+                else if (r < p.minShare + p.maxShare) sum += heap.popMax();
+                else                                  heap.push(static_cast<int>(rng()));
+            }
+        });
+        Benchmark::keep(sum);
+
+        const std::string label = std::string(name) + ", " + p.name;
+        Benchmark::report(label.c_str(), PHASE_OPS, seconds);
+    }
+}
+
+int main() {
+    printf("n = %zu, %zu operations per phase\n", N, PHASE_OPS);
+
+    MinMaxHeap minMax;
+    run("MinMaxHeap", minMax);
+    Deap deap;
+    run("Deap", deap);
+
+    AutoDepq<int> autoDepq;
+    run("AutoDepq", autoDepq);
+    printf("AutoDepq: backend %zu at the end, %zu migrations\n", autoDepq.backend(), autoDepq.migrations());
+    return 0;
+}
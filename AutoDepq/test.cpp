@@ -0,0 +1,134 @@
+#include "AutoDepq.h"
+#include "Depq.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include "gtest/gtest.h"
+#include <iterator>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+static_assert(Depq_Trait::isDepq<MinMaxHeap>, "MinMaxHeap should satisfy the DEPQ interface");
+static_assert(Depq_Trait::isDepq<BasicDeap<double>>, "Deap should satisfy the DEPQ interface");
+static_assert(!Depq_Trait::isDepq<std::vector<int>>, "std::vector is not a DEPQ");
+
+/// 不量時間的 policy：popMax 比 popMin 多時 Deap 比較便宜，否則 MinMaxHeap 比較便宜
+struct FakePolicy : AutoDepqPolicy {
+    static constexpr size_t CALIBRATION_OPS = 64;
+    static constexpr size_t WINDOW = 200;
+
+    template<typename Heap, typename Func>
+    static double cost(const DepqWorkload& w, Func&& run) {
+        run();
+        const bool deap = std::is_same<Heap, BasicDeap<typename Heap::value_type>>::value;
+        return (w.maxShare > w.minShare) == deap ? 1 : 2;
+    }
+};
+
+TEST(AutoDepq, calibrate) {
+    AutoDepq<int, FakePolicy> heap;
+    ASSERT_THROW(heap.popMin(), std::out_of_range);
+    ASSERT_THROW(heap.peekMax(), std::out_of_range);
+
+    for (int v : {5, 1, 9, 3}) heap.push(v);
+    ASSERT_TRUE(heap.backend() == 0);
+
+    // 空的 sample 不做任何事
+    heap.calibrate({}, DepqWorkload{ 0, 0, 0.5 });
+    ASSERT_TRUE(heap.backend() == 0);
+
+    heap.calibrate({1, 2, 3}, DepqWorkload{ 3, 0.1, 0.4 });
+    ASSERT_TRUE(heap.backend() == 1 && heap.migrations() == 1);
+    ASSERT_TRUE(heap.size() == 4 && heap.peekMin() == 1 && heap.peekMax() == 9);
+
+    heap.calibrate({1, 2, 3}, DepqWorkload{ 3, 0.4, 0.1 });
+    ASSERT_TRUE(heap.backend() == 0 && heap.migrations() == 2);
+    ASSERT_TRUE(heap.popMin() == 1 && heap.popMax() == 9);
+}
+
+TEST(AutoDepq, drift) {
+    std::vector<int> init{8, 6, 7, 5, 3, 0, 9};
+    AutoDepq<int, FakePolicy> heap(init.begin(), init.end());
+    std::multiset<int> expected(init.begin(), init.end());
+    std::mt19937 rng(3);
+
+    // 每一個階段 pop 的方向不同，內容在切換實作後仍要正確
+    auto phase = [&](bool max) {
+        for (size_t i = 0; i < 3 * FakePolicy::WINDOW; ++i) {
+            if (rng() % 2 || expected.empty()) {
+                const int v = rng() % 1000;
+                heap.push(v);
+                expected.insert(v);
+            }
+            else if (max) {
+                ASSERT_TRUE(heap.popMax() == *expected.rbegin());
+                expected.erase(std::prev(expected.end()));
+            }
+            else {
+                ASSERT_TRUE(heap.popMin() == *expected.begin());
+                expected.erase(expected.begin());
+            }
+            ASSERT_TRUE(heap.size() == expected.size());
+        }
+    };
+
+    phase(false);
+    ASSERT_TRUE(heap.needsRecalibration());
+    heap.recalibrate();
+    ASSERT_TRUE(!heap.needsRecalibration());
+    ASSERT_TRUE(heap.backend() == 0);
+    ASSERT_TRUE(heap.calibrated().minShare > 0.3 && heap.calibrated().maxShare == 0);
+
+    // push、pop 只會標記，不會自己切換實作
+    phase(true);
+    ASSERT_TRUE(heap.needsRecalibration() && heap.backend() == 0 && heap.migrations() == 0);
+    heap.recalibrate();
+    ASSERT_TRUE(heap.backend() == 1 && heap.migrations() == 1);
+
+    // popMin、popMax 的比例沒有改變時不會切換（大小改變仍可能要求重新校準）
+    phase(true);
+    heap.recalibrate();
+    ASSERT_TRUE(heap.migrations() == 1);
+
+    phase(false);
+    ASSERT_TRUE(heap.needsRecalibration());
+    heap.recalibrate();
+    ASSERT_TRUE(heap.backend() == 0 && heap.migrations() == 2);
+}
+
+/// recalibrate() 的 sample 有上限，成本和 heap 的大小無關
+struct SampledPolicy : FakePolicy {
+    static constexpr size_t SAMPLE = 16;
+};
+
+TEST(AutoDepq, recalibrateSample) {
+    typedef Benchmark::Counted Counted;
+    AutoDepq<Counted, SampledPolicy> heap;
+    const int n = 20000;
+    for (int i = 0; i < n; ++i) heap.push(Counted{ (i * 7919) % n });
+    ASSERT_TRUE(heap.needsRecalibration());
+
+    // 只有 push 時 FakePolicy 選擇目前的實作，不需要搬移，比較次數只來自 sample
+    Counted::comparisons = 0;
+    heap.recalibrate();
+    ASSERT_TRUE(heap.backend() == 0 && heap.migrations() == 0);
+    ASSERT_TRUE(Counted::comparisons < 4000) << Counted::comparisons;
+    ASSERT_TRUE(heap.calibrated().size == size_t(n));
+
+    for (int i = 0; i < n; ++i) ASSERT_TRUE(heap.popMin().value == i);
+}
+
+TEST(AutoDepq, defaultPolicy) {
+    std::vector<int> sample(1000);
+    for (size_t i = 0; i < sample.size(); ++i) sample[i] = static_cast<int>((i * 7919) % 1000);
+
+    AutoDepq<int> heap;
+    heap.calibrate(sample, DepqWorkload{ sample.size(), 0.25, 0.25 });
+    ASSERT_TRUE(heap.backend() < 2);
+
+    for (int v : sample) heap.push(v);
+    for (int i = 0; i < 500; ++i) ASSERT_TRUE(heap.popMin() == i);
+    for (int i = 999; i >= 500; --i) ASSERT_TRUE(heap.popMax() == i);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file Benchmark.h
+ * @brief 各資料夾中 bench.cpp 共用的計時工具
+ * @note 跑 benchmark 時請用 Release 建置，Debug 建置的數字沒有參考價值
+ */
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <stddef.h>
+#include <stdio.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Benchmark {
+    /// 計時器，建立時開始計時
+    class Timer {
+        std::chrono::steady_clock::time_point m_start;
+
+    public:
+        Timer() : m_start(std::chrono::steady_clock::now()) {}
+
+        /// 重新開始計時
+        void reset() { m_start = std::chrono::steady_clock::now(); }
+
+        /// 從開始計時到現在經過的秒數
+        double seconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        }
+    };
+
+    /// @brief 執行 func 並回傳花費的秒數
+    /// @tparam Func - 不需要參數的 callable
+    template<typename Func>
+    double measure(Func&& func) {
+        Timer timer;
+        func();
+        return timer.seconds();
+    }
+
+    /// @brief 讓編譯器無法把算出來的值最佳化掉
+    /// @details 把 value 的位址交給編譯器看不透的地方（GCC、Clang 用空的 inline asm，MSVC 用 volatile 指標），
+    /// 所以 value 一定要被算出來並放在記憶體中；GCC、Clang 不會產生額外的讀寫
+    template<typename T>
+    inline void keep(const T& value) {
+#if defined(_MSC_VER)
+        static const void* volatile sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "g"(&value) : "memory");
+#endif
+    }
+
+    /// @brief 會計算比較次數的 int，用來量測演算法的比較次數
+    struct Counted {
+        int value;
+        static inline size_t comparisons = 0;
+
+        friend bool operator< (const Counted& a, const Counted& b) { ++comparisons; return a.value <  b.value; }
+        friend bool operator> (const Counted& a, const Counted& b) { ++comparisons; return a.value >  b.value; }
+        friend bool operator<=(const Counted& a, const Counted& b) { ++comparisons; return a.value <= b.value; }
+        friend bool operator>=(const Counted& a, const Counted& b) { ++comparisons; return a.value >= b.value; }
+        friend bool operator==(const Counted& a, const Counted& b) { ++comparisons; return a.value == b.value; }
+    };
+
+    /// @brief 印出一列結果
+    /// @param name - 測試的名稱
+    /// @param ops - 操作的次數
+    /// @param seconds - 總共花費的秒數
+    inline void report(const char* name, size_t ops, double seconds) {
+        printf("%-52s %12.2f ns/op %10.2f Mop/s\n", name, seconds * 1e9 / ops, ops / seconds / 1e6);
+    }
+}
+
+#endif // BENCHMARK_H
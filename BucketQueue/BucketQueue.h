@@ -0,0 +1,254 @@
+/**
+ * @file BucketQueue.h
+ * @brief 值為小範圍整數時使用的 double-ended priority queue，不需要比較大小
+ */
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H
+
+#include "MinMaxHeap.h"
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// BucketQueue 使用的位元運算
+namespace BucketQueue_Trait {
+    /// 一個 word 有幾個 bit
+    constexpr size_t WORD_BITS = 64;
+
+    /// @brief 最低位的 1 在第幾個 bit
+    /// @pre word != 0
+    inline size_t lowestBit(uint64_t word) {
+#if defined(_MSC_VER)
+        unsigned long id;
+        _BitScanForward64(&id, word);
+        return id;
+#else
+        return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+    }
+
+    /// @brief 最高位的 1 在第幾個 bit
+    /// @pre word != 0
+    inline size_t highestBit(uint64_t word) {
+#if defined(_MSC_VER)
+        unsigned long id;
+        _BitScanReverse64(&id, word);
+        return id;
+#else
+        return WORD_BITS - 1 - static_cast<size_t>(__builtin_clzll(word));
+#endif
+    }
+
+    /// @brief 值的範圍。預設只有 8、16 位元的整數是有界的，其他型別可以自行特化
+    /// @tparam T - 元素的型別
+    template<typename T>
+    struct key_range {
+        static constexpr bool bounded = std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 2;
+        static constexpr T low  = std::numeric_limits<T>::min();
+        static constexpr T high = std::numeric_limits<T>::max();
+    };
+
+    /// 範圍超過這個大小時，bucket 陣列太佔記憶體，改用 heap
+    constexpr uint64_t MAX_RANGE = uint64_t(1) << 20;
+}
+
+/**
+ * @brief 值為 [low, high] 內整數的 double-ended priority queue
+ * @tparam T - 整數型別
+ * @details
+ * 每個值都有一個 bucket，記錄這個值有幾個，所以 push 和 pop 都不需要比較大小。
+ *
+ * 為了快速找到最小和最大的非空 bucket，用多層的 bitmap 記錄哪些 bucket 非空：
+ * - 第 0 層的第 i 個 bit 代表第 i 個 bucket 是否非空
+ * - 第 k + 1 層的第 i 個 bit 代表第 k 層的第 i 個 word 是否不為 0
+ * - 最上層只有一個 word
+ *
+ * 找最小值時從最上層開始，每層用 ctz 找最低位的 1 就知道下一層要看哪個 word；找最大值時改用 clz。
+ * 範圍為 2^20 時只有 4 層，所以 push、popMin、popMax 都是 O(log_64 range)。
+ */
+template<typename T>
+class BucketQueue {
+    static_assert(std::is_integral<T>::value, "BucketQueue - T must be an integral type");
+
+public:
+    typedef T value_type;
+
+private:
+    value_type m_low;
+    value_type m_high;
+    size_t m_size = 0;
+
+    /// 每個值有幾個
+    std::vector<size_t> m_count;
+    /// m_bits[0] 是最下層
+    std::vector<std::vector<uint64_t>> m_bits;
+
+public:
+    /// @brief 建立空的 BucketQueue，範圍為 BucketQueue_Trait::key_range<T>
+    BucketQueue() : BucketQueue(BucketQueue_Trait::key_range<T>::low, BucketQueue_Trait::key_range<T>::high) {}
+
+    /// @brief 建立空的 BucketQueue
+    /// @param low - 最小可能的值（包含）
+    /// @param high - 最大可能的值（包含）
+    /// @throw std::invalid_argument - 如果 low > high，或範圍 high - low + 1 超過 BucketQueue_Trait::MAX_RANGE
+    BucketQueue(value_type low, value_type high) : m_low(low), m_high(high) {
+        using BucketQueue_Trait::WORD_BITS;
+        if (low > high) throw std::invalid_argument("BucketQueue - low must not be greater than high");
+        // 和 select 使用同樣的上限；也避免 64 位元的完整範圍在 + 1 時溢位
+        if (uint64_t(index(high)) >= BucketQueue_Trait::MAX_RANGE) throw std::invalid_argument("BucketQueue - range is too wide");
+
+        const size_t range = index(high) + 1;
+        m_count.assign(range, 0);
+
+        size_t words = range;
+        do {
+            words = (words + WORD_BITS - 1) / WORD_BITS;
+            m_bits.emplace_back(words, 0);
+        } while (words > 1);
+    }
+
+    /// @brief 從 [first, last) 建立 BucketQueue，範圍為 BucketQueue_Trait::key_range<T>
+    /// @tparam InputIt - 滿足 input iterator。排除整數型別，否則 T 比 int 窄時 `BucketQueue<uint8_t>(10, 200)` 會選到這個建構子
+    template<typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+    BucketQueue(InputIt first, InputIt last) : BucketQueue() {
+        for (; first != last; ++first) push(*first);
+    }
+
+    /// @brief 插入 value
+    /// @throw std::out_of_range - 如果 value 不在 [low, high] 內
+    void push(value_type value) {
+        if (value < m_low || value > m_high) throw std::out_of_range("BucketQueue::push - value out of range");
+
+        const size_t id = index(value);
+        if (m_count[id]++ == 0) setBit(id);
+        ++m_size;
+    }
+
+    /// @brief 移除最小值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMin() {
+        if (m_size == 0) throw std::out_of_range("BucketQueue::popMin - no element");
+        return take(findMin());
+    }
+
+    /// @brief 移除最大值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMax() {
+        if (m_size == 0) throw std::out_of_range("BucketQueue::popMax - no element");
+        return take(findMax());
+    }
+
+    /// @brief 回傳最小值，不移除
+    /// @throw std::out_of_range - 如果為空
+    value_type peekMin() const {
+        if (m_size == 0) throw std::out_of_range("BucketQueue::peekMin - no element");
+        return value(findMin());
+    }
+
+    /// @brief 回傳最大值，不移除
+    /// @throw std::out_of_range - 如果為空
+    value_type peekMax() const {
+        if (m_size == 0) throw std::out_of_range("BucketQueue::peekMax - no element");
+        return value(findMax());
+    }
+
+    /// 有幾個元素
+    size_t size() const { return m_size; }
+
+private:
+    /// 值對應的 bucket
+    size_t index(value_type v) const {
+        typedef typename std::make_unsigned<value_type>::type U;
+        // 8、16 位元的型別相減時會被提升成 int，所以要再轉回 U
+        return static_cast<size_t>(static_cast<U>(static_cast<U>(v) - static_cast<U>(m_low)));
+    }
+
+    /// bucket 對應的值
+    value_type value(size_t id) const {
+        typedef typename std::make_unsigned<value_type>::type U;
+        return static_cast<value_type>(static_cast<U>(static_cast<U>(m_low) + static_cast<U>(id)));
+    }
+
+    /// @brief bucket id 從空變成非空
+    void setBit(size_t id) {
+        using BucketQueue_Trait::WORD_BITS;
+        for (auto& level : m_bits) {
+            uint64_t& word = level[id / WORD_BITS];
+            const bool wasEmpty = word == 0;
+            word |= uint64_t(1) << (id % WORD_BITS);
+
+            // 這個 word 本來就非空，上層的 bit 已經設好了
+            if (!wasEmpty) return;
+            id /= WORD_BITS;
+        }
+    }
+
+    /// @brief bucket id 從非空變成空
+    void clearBit(size_t id) {
+        using BucketQueue_Trait::WORD_BITS;
+        for (auto& level : m_bits) {
+            uint64_t& word = level[id / WORD_BITS];
+            word &= ~(uint64_t(1) << (id % WORD_BITS));
+
+            // 這個 word 還有其他非空的 bucket，上層的 bit 不用清
+            if (word != 0) return;
+            id /= WORD_BITS;
+        }
+    }
+
+    /// @brief 最小的非空 bucket
+    /// @pre m_size != 0
+    size_t findMin() const {
+        using namespace BucketQueue_Trait;
+        size_t id = 0;
+        for (size_t lv = m_bits.size(); lv-- > 0; )
+            id = id * WORD_BITS + lowestBit(m_bits[lv][id]);
+        return id;
+    }
+
+    /// @brief 最大的非空 bucket
+    /// @pre m_size != 0
+    size_t findMax() const {
+        using namespace BucketQueue_Trait;
+        size_t id = 0;
+        for (size_t lv = m_bits.size(); lv-- > 0; )
+            id = id * WORD_BITS + highestBit(m_bits[lv][id]);
+        return id;
+    }
+
+    /// @brief 從 bucket id 拿走一個值
+    value_type take(size_t id) {
+        if (--m_count[id] == 0) clearBit(id);
+        --m_size;
+        return value(id);
+    }
+};
+
+namespace BucketQueue_Trait {
+    /// @brief 依元素型別選擇 double-ended priority queue 的實作。預設使用 BasicMinMaxHeap；如果 key_range<T> 有界而且範圍不超過 MAX_RANGE，則使用 BucketQueue
+    template<typename T, typename = void>
+    struct select {
+        typedef BasicMinMaxHeap<T> type;
+    };
+
+    template<typename T>
+    struct select<T, typename std::enable_if<
+        key_range<T>::bounded &&
+        uint64_t(key_range<T>::high) - uint64_t(key_range<T>::low) < MAX_RANGE
+    >::type> {
+        typedef BucketQueue<T> type;
+    };
+}
+
+/// @brief 依 T 自動選擇的 double-ended priority queue，例如 `DefaultDepq<uint8_t>` 為 BucketQueue，`DefaultDepq<int>` 為 MinMaxHeap
+template<typename T>
+using DefaultDepq = typename BucketQueue_Trait::select<T>::type;
+
+#endif // BUCKETQUEUE_H
@@ -0,0 +1,48 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 BucketQueue 和 MinMaxHeap、Deap 在不同值域大小下的 push、pop 速度
+ */
+#include "BucketQueue.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include <random>
+#include <string>
+#include <vector>
+
+static const size_t N = 1000000;
+
+/// 先 push 全部，再交錯 popMin、popMax 直到清空
+template<typename Queue>
+static void bench(const std::string& name, Queue queue, const std::vector<uint32_t>& data)
+{
+    const double tPush = Benchmark::measure([&] {
+        for (uint32_t v : data) queue.push(v);
+    });
+    Benchmark::report((name + " push").c_str(), data.size(), tPush);
+
+    const double tPop = Benchmark::measure([&] {
+        for (size_t i = 0; i < data.size(); ++i)
+            Benchmark::keep((i & 1) ? queue.popMin() : queue.popMax());
+    });
+    Benchmark::report((name + " pop").c_str(), data.size(), tPop);
+}
+
+int main()
+{
+    std::mt19937 gen(12345);
+
+    for (int bits : {8, 12, 16, 20}) {
+        const uint32_t range = uint32_t(1) << bits;
+        std::uniform_int_distribution<uint32_t> dist(0, range - 1);
+        std::vector<uint32_t> data(N);
+        for (uint32_t& v : data) v = dist(gen);
+
+        printf("== range = 2^%d, %zu values ==\n", bits, N);
+        bench("BucketQueue", BucketQueue<uint32_t>(0, range - 1), data);
+        bench("MinMaxHeap", BasicMinMaxHeap<uint32_t>(), data);
+        bench("Deap", BasicDeap<uint32_t>(), data);
+    }
+
+    return 0;
+}
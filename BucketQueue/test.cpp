@@ -0,0 +1,124 @@
+#include "BucketQueue.h"
+#include "Depq.h"
+#include "MinMaxHeap.h"
+#include "gtest/gtest.h"
+#include <climits>
+#include <type_traits>
+#include <vector>
+#include <stdint.h>
+
+static_assert(Depq_Trait::isDepq<BucketQueue<uint8_t>> && !Depq_Trait::isMigratable<BucketQueue<uint8_t>>, "BucketQueue should satisfy the DEPQ interface");
+
+TEST(BucketQueue, bitTest) {
+    using namespace BucketQueue_Trait;
+    ASSERT_TRUE(lowestBit(1) == 0);
+    ASSERT_TRUE(highestBit(1) == 0);
+    ASSERT_TRUE(lowestBit(0b101000) == 3);
+    ASSERT_TRUE(highestBit(0b101000) == 5);
+    ASSERT_TRUE(lowestBit(uint64_t(1) << 63) == 63);
+    ASSERT_TRUE(highestBit(UINT64_MAX) == 63);
+}
+
+TEST(BucketQueue, selectTest) {
+    static_assert(std::is_same<DefaultDepq<uint8_t>, BucketQueue<uint8_t>>::value, "");
+    static_assert(std::is_same<DefaultDepq<int16_t>, BucketQueue<int16_t>>::value, "");
+    static_assert(std::is_same<DefaultDepq<int>, MinMaxHeap>::value, "");
+    static_assert(std::is_same<DefaultDepq<bool>, BasicMinMaxHeap<bool>>::value, "");
+}
+
+TEST(BucketQueue, popTest) {
+    // 1, 3, 3, 6, 8, 9
+    BucketQueue<int> queue(0, 9);
+    for (int v : {9, 1, 6, 3, 3, 8}) queue.push(v);
+
+    ASSERT_TRUE(queue.popMin() == 1);
+    ASSERT_TRUE(queue.popMin() == 3);
+    ASSERT_TRUE(queue.popMin() == 3);
+    ASSERT_TRUE(queue.popMax() == 9);
+    ASSERT_TRUE(queue.popMax() == 8);
+    ASSERT_TRUE(queue.popMax() == 6);
+
+    ASSERT_THROW(queue.popMin(), std::out_of_range);
+    ASSERT_THROW(queue.popMax(), std::out_of_range);
+    ASSERT_THROW(queue.push(10), std::out_of_range);
+    ASSERT_THROW(queue.push(-1), std::out_of_range);
+    ASSERT_THROW(BucketQueue<int>(1, 0), std::invalid_argument);
+}
+
+TEST(BucketQueue, signedTest) {
+    BucketQueue<int8_t> queue;
+    for (int v : {-128, 127, 0, -1, 1}) queue.push(static_cast<int8_t>(v));
+
+    ASSERT_TRUE(queue.size() == 5);
+    ASSERT_TRUE(queue.peekMin() == -128);
+    ASSERT_TRUE(queue.peekMax() == 127);
+    ASSERT_TRUE(queue.popMin() == -128);
+    ASSERT_TRUE(queue.popMin() == -1);
+    ASSERT_TRUE(queue.popMax() == 127);
+    ASSERT_TRUE(queue.popMax() == 1);
+    ASSERT_TRUE(queue.popMax() == 0);
+}
+
+TEST(BucketQueue, narrowRange) {
+    // T 比 int 窄時，(low, high) 不能被當成 iterator
+    BucketQueue<uint8_t> queue(10, 200);
+    ASSERT_THROW(queue.push(201), std::out_of_range);
+    for (int v : {10, 200, 50}) queue.push(static_cast<uint8_t>(v));
+    ASSERT_TRUE(queue.popMin() == 10);
+    ASSERT_TRUE(queue.popMax() == 200);
+
+    BucketQueue<int16_t> wide(-300, 300);
+    ASSERT_THROW(wide.push(-301), std::out_of_range);
+    for (int v : {-300, 7, 300}) wide.push(static_cast<int16_t>(v));
+    ASSERT_TRUE(wide.popMax() == 300);
+    ASSERT_TRUE(wide.popMin() == -300);
+    ASSERT_TRUE(wide.peekMin() == 7);
+
+    std::vector<uint8_t> values{3, 1, 2};
+    BucketQueue<uint8_t> fromRange(values.begin(), values.end());
+    ASSERT_TRUE(fromRange.size() == 3 && fromRange.peekMax() == 3);
+}
+
+TEST(BucketQueue, wideRange) {
+    using BucketQueue_Trait::MAX_RANGE;
+
+    // 剛好 MAX_RANGE 個值可以，多一個就不行
+    BucketQueue<int> largest(0, int(MAX_RANGE - 1));
+    largest.push(int(MAX_RANGE - 1));
+    largest.push(0);
+    ASSERT_TRUE(largest.popMax() == int(MAX_RANGE - 1) && largest.popMin() == 0);
+    ASSERT_THROW(BucketQueue<int>(0, int(MAX_RANGE)), std::invalid_argument);
+
+    // 完整的 32 位元和 64 位元範圍（後者在 + 1 時會溢位成 0）
+    ASSERT_THROW(BucketQueue<int>(INT_MIN, INT_MAX), std::invalid_argument);
+    ASSERT_THROW(BucketQueue<int64_t>(INT64_MIN, INT64_MAX), std::invalid_argument);
+    ASSERT_THROW(BucketQueue<uint64_t>(0, UINT64_MAX), std::invalid_argument);
+}
+
+TEST(BucketQueue, randomTest) {
+    unsigned seed = time(NULL);
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+
+    // 範圍跨過多層 bitmap
+    for (int range : {10, 64, 65, 4096, 4097, 300000}) {
+        BucketQueue<int> queue(-range / 2, range - range / 2 - 1);
+        MinMaxHeap expected;
+
+        for (int i = 0; i < 2000; ++i) {
+            if (expected.size() == 0 || rand() % 3 != 0) {
+                const int v = rand() % range - range / 2;
+                queue.push(v);
+                expected.push(v);
+            }
+            else if (rand() & 1) ASSERT_TRUE(queue.popMin() == expected.popMin());
+            else                 ASSERT_TRUE(queue.popMax() == expected.popMax());
+
+            ASSERT_TRUE(queue.size() == expected.size());
+            if (expected.size()) {
+                ASSERT_TRUE(queue.peekMin() == expected.peekMin());
+                ASSERT_TRUE(queue.peekMax() == expected.peekMax());
+            }
+        }
+    }
+}
@@ -5,9 +5,20 @@
 #ifndef DEAP_H
 #define DEAP_H
 
+#include "Sortedness.h"
 #include <assert.h>
+#include <stddef.h>
 #include <vector>
 #include <initializer_list>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#ifndef NDEBUG
+#include <iostream>
+#endif
 
 /**
  * @brief Deap 中節點 index 的計算函數，index 為 0-indexed
@@ -84,33 +95,68 @@ namespace Deap_Trait {
  * 只要mi <= Mj，那麼：
  * > m1 <= m2 <= ... <= mi <= Mj <= ... <= M2 <= M1
  * 顯然的，當mi <= Mj時，path上的其他節點必定會滿足條件3。
+ *
+ * @tparam T - 元素的型別，需要支援 `<`、`>`、`<=`
+ * @tparam Storage - 存放元素的容器，介面和 std::vector 相同（index 存取、push_back、pop_back、insert 到尾端……），
+ *                   例如 std::vector（BasicDeap）或固定容量的 StaticVector
  */
-class Deap {
+template<typename T, typename Storage>
+class GenericDeap {
 public:
-    typedef int value_type;
+    typedef T value_type;
 
 private:
-    std::vector<value_type> m_data;
+    Storage m_data;
 
 public:
     /// @brief 建立空的Deap
-    Deap() = default;
+    GenericDeap() = default;
+
+    /// @brief 直接使用已經排成 Deap 的 storage，不重新建立
+    /// @details 讓 Storage 為指向外部記憶體的 view 時（例如 HeapForest），可以在別人管理的記憶體上執行 Deap 的操作
+    /// @param storage - 內容已經是 Deap 的排列
+    static GenericDeap adopt(Storage storage) {
+        GenericDeap heap;
+        heap.m_data = std::move(storage);
+        return heap;
+    }
 
     /// @brief 將[first, last)內的元素插入Deap
     /// @tparam InputIt - Input Iterator型別
     /// @param first - 開始（含）
     /// @param last - 結尾（不含）
     template<typename InputIt>
-    Deap(InputIt first, InputIt last) : m_data(first, last) { buildDeap(); }
+    GenericDeap(InputIt first, InputIt last) : m_data(first, last) { buildDeap(); }
 
     /// @brief 將list中的所有內容插入Deap內
     /// @param list - 初始化串列
-    Deap(std::initializer_list<value_type> list) : m_data(list) { buildDeap(); }
+    GenericDeap(std::initializer_list<value_type> list) : m_data(list.begin(), list.end()) { buildDeap(); }
 
     /// @brief 插入新的值
     /// @param v - 新的值
     void push(const value_type& v) { m_data.push_back(v); insert(m_data.size() - 1); }
 
+    /// @brief 一次插入 [first, last) 內的所有值
+    /// @details 插入的數量夠多時，直接呼叫 buildDeap() 重建（O(n + k)），否則一個一個 push（O(k log n)）
+    /// @tparam ForwardIt - Forward Iterator型別
+    /// @param first - 開始（含）
+    /// @param last - 結尾（不含）
+    template<typename ForwardIt>
+    void pushRange(ForwardIt first, ForwardIt last) {
+        const size_t k = static_cast<size_t>(std::distance(first, last));
+
+        size_t logN = 1;
+        for (size_t n = m_data.size() + k; n > 1; n >>= 1) ++logN;
+
+        if (k * logN > m_data.size() + k) {
+            m_data.insert(m_data.end(), first, last);
+            buildDeap();
+        }
+        else {
+            for (; first != last; ++first) push(*first);
+        }
+    }
+
     /// @brief 移除最小值並返回
     /// @throw std::out_of_range - 如果Deap為空
     value_type popMin();
@@ -119,8 +165,39 @@ public:
     /// @throw std::out_of_range - 如果Deap為空
     value_type popMax();
 
+    /// @brief 回傳最小值，不移除
+    /// @throw std::out_of_range - 如果Deap為空
+    const value_type& peekMin() const;
+
+    /// @brief 回傳最大值，不移除
+    /// @throw std::out_of_range - 如果Deap為空
+    const value_type& peekMax() const;
+
     size_t size() const { return m_data.size(); }
 
+    /// @brief 依內部的排列順序（不是排序好的順序）走訪所有元素，可以搭配範圍建構子把內容搬到其他 heap
+    auto begin() const { return m_data.begin(); }
+    auto end() const { return m_data.end(); }
+
+    /// @brief 回傳第 k 小的值，不會修改Deap
+    /// @param k - 排名，從 1 開始（`kthSmallest(1)` 即為最小值）
+    /// @throw std::out_of_range - 如果 k 為 0 或大於 size()
+    /// @note 只會走訪Deap上層的節點，時間複雜度為 O(k log k)
+    value_type kthSmallest(size_t k) const;
+
+    /// @brief 回傳第 k 大的值，不會修改Deap
+    /// @param k - 排名，從 1 開始（`kthLargest(1)` 即為最大值）
+    /// @throw std::out_of_range - 如果 k 為 0 或大於 size()
+    /// @note 只會走訪Deap上層的節點，時間複雜度為 O(k log k)
+    value_type kthLargest(size_t k) const;
+
+    /// @brief 將所有元素排序後移到 out，呼叫後Deap為空
+    /// @details 不是逐一 pop 的 heap sort，而是直接對 m_data 做 std::sort 再移到 out：
+    /// Deap的 pop 需要 m_data 的尾端，無法原地放置取出的值。時間複雜度同樣是 O(n log n)，不需要額外配置記憶體
+    /// @param out - 存放結果，原本的內容會被丟棄
+    /// @param ascending - `true`，由小到大；`false`，由大到小
+    void drainSorted(std::vector<value_type>& out, bool ascending = true);
+
 private:
     /// 是否存在
     bool exist(size_t id) const { return id < m_data.size(); }
@@ -136,9 +213,18 @@ private:
         return exist(corr) ? corr : Deap_Trait::parent(corr);
     }
 
+    /// @brief kthSmallest 和 kthLargest 的實作
+    /// @param k - 排名，從 1 開始
+    /// @param smallest - `true`，找第 k 小；`false`，找第 k 大
+    value_type kthElement(size_t k, bool smallest) const;
+
     /// 初始化時呼叫，將m_data的內容轉成Deap
     void buildDeap();
 
+    /// @brief 把已經排序的 m_data 原地擺成Deap，不需要比較
+    /// @param ascending - m_data 是遞增還是遞減
+    void layoutSorted(bool ascending);
+
     /// @brief 當有新的值插入原本符合規範的Deap
     /// @param id - 葉子節點的index
     void insert(size_t id);
@@ -162,4 +248,506 @@ public:
 #endif
 };
 
+/// 用 std::vector 存放元素的Deap
+template<typename T>
+using BasicDeap = GenericDeap<T, std::vector<T>>;
+
+/// 存放 int 的Deap
+typedef BasicDeap<int> Deap;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename T, typename Storage>
+typename GenericDeap<T, Storage>::value_type GenericDeap<T, Storage>::popMin()
+{
+    using namespace Deap_Trait;
+
+    if (m_data.size() == 0) throw std::out_of_range("Deap::popMin - No element");
+
+    const value_type ret = m_data[0];
+
+    /**
+     * # 演算法
+     * 最小值被移除後，要不斷地將較小的子節點往上移。
+     */
+    size_t emptyNode = 0;
+    // 只要底下還有子節點
+    while (!isLeaf(emptyNode)) {
+        const size_t L = leftChild(emptyNode), R = rightChild(emptyNode);
+
+        // 如果左子節點比較小
+        if (!exist(R) || m_data[L] < m_data[R]) {
+            m_data[emptyNode] = std::move(m_data[L]); // 將左子節點往上移
+            emptyNode = L;
+        }
+        // 否則，移動右子節點
+        else {
+            m_data[emptyNode] = std::move(m_data[R]);
+            emptyNode = R;
+        }
+    }
+
+    if (emptyNode == m_data.size() - 1) {
+        /**
+         * @note Edge Case: 如果最後一個元素被往上提了，那可以保證性質3不會被違反。
+         * 最後一個元素在min heap => 在max heap中對應的位置是空的 => 最後一個元素的「safeCorrespond」是對應位置的父節點。
+         * 當最後一個元素被往上提時，「safeCorrespnd」不變。
+         */
+        m_data.pop_back();
+    }
+    else {
+        /**
+         * 往上移後形成的空位，拿最後一個元素補，然後呼叫 insert()
+         */
+        m_data[emptyNode] = std::move(m_data.back()); // 否則拿最後一個元素補
+        m_data.pop_back();
+        this->insert(emptyNode);
+    }
+
+    return ret;
+}
+
+template<typename T, typename Storage>
+typename GenericDeap<T, Storage>::value_type GenericDeap<T, Storage>::popMax()
+{
+    using namespace Deap_Trait;
+
+    if (m_data.size() == 0) throw std::out_of_range("Deap::popMin - No element");
+    
+    if (m_data.size() == 1) {
+        const value_type ret = m_data.front(); // 回傳第一個元素
+        m_data.pop_back();
+        return ret;
+    }
+
+    const value_type ret = m_data[1];
+
+    /**
+     * # 演算法
+     * 最大元素被移除後，要不斷拿較大的子節點往上遞補。
+     */
+    size_t emptyNode = 1;
+    while (!isLeaf(emptyNode)) {
+        const size_t L = leftChild(emptyNode), R = rightChild(emptyNode);
+
+        // 左子節點比較大
+        if (!exist(R) || m_data[L] > m_data[R]) {
+            m_data[emptyNode] = std::move(m_data[L]);
+            emptyNode = L;
+        }
+        else {
+            m_data[emptyNode] = std::move(m_data[R]);
+            emptyNode = R;
+        }
+    }
+
+    if (emptyNode == m_data.size() - 1) {
+        /**
+         * @note Edge Case: 最後一個元素被往上遞補
+         * > 為討論方便，原本「在min heap中和最後一個元素對應」的節點被稱作P
+         * >
+         * > - Case 1: 最後一個元素在 parent 的右子樹 -> 不用管  
+         * >   在最後一個元素往上移後，P的「safeCorrespond」仍是原本的最後一個元素。
+         * >
+         * > - Case 2: 最後一個元素在 parent 的左子樹 -> 往上移後對 parent 呼叫 insert  
+         * >   原本只有P和最後一個元素互相對應，但往上移後，P和「P的兄弟節點」的「safeCorrespond」都會是原本的最後一個元素。
+         * >   所以要呼叫 insert 來避免「P的兄弟節點」和最後一個元素衝突。
+         */
+        m_data.pop_back();
+        if (isLeaf(parent(emptyNode)))
+            this->insert(parent(emptyNode));
+    }
+    else {
+        /**
+         * 往上移後形成的空位，拿最後一個元素補，然後呼叫 insert()
+         */
+        m_data[emptyNode] = std::move(m_data.back());
+        m_data.pop_back();
+        this->insert(emptyNode);
+    }
+
+    return ret;
+}
+
+template<typename T, typename Storage>
+const typename GenericDeap<T, Storage>::value_type& GenericDeap<T, Storage>::peekMin() const
+{
+    if (m_data.size() == 0) throw std::out_of_range("Deap::peekMin - No element");
+    return m_data[0];
+}
+
+template<typename T, typename Storage>
+const typename GenericDeap<T, Storage>::value_type& GenericDeap<T, Storage>::peekMax() const
+{
+    if (m_data.size() == 0) throw std::out_of_range("Deap::peekMax - No element");
+    // 只有一個元素時，它放在 min heap 的根
+    return m_data.size() == 1 ? m_data[0] : m_data[1];
+}
+
+template<typename T, typename Storage>
+typename GenericDeap<T, Storage>::value_type GenericDeap<T, Storage>::kthSmallest(size_t k) const
+{
+    if (k == 0 || k > m_data.size()) throw std::out_of_range("Deap::kthSmallest - k out of range");
+    return kthElement(k, true);
+}
+
+template<typename T, typename Storage>
+typename GenericDeap<T, Storage>::value_type GenericDeap<T, Storage>::kthLargest(size_t k) const
+{
+    if (k == 0 || k > m_data.size()) throw std::out_of_range("Deap::kthLargest - k out of range");
+    return kthElement(k, false);
+}
+
+/**
+ * @details
+ * Deap的 popMin、popMax 都以 m_data 的大小決定哪些節點還存在，所以不能像 MinMaxHeap 一樣把取出的值放在 m_data 的尾端。
+ * 一個一個 pop 到 out 需要第二份 n 個元素的空間，而直接對 m_data 排序一樣是 O(n log n)，而且不需要額外的空間。
+ */
+template<typename T, typename Storage>
+void GenericDeap<T, Storage>::drainSorted(std::vector<value_type>& out, bool ascending)
+{
+    if (ascending) std::sort(m_data.begin(), m_data.end());
+    else           std::sort(m_data.begin(), m_data.end(), std::greater<value_type>());
+
+    if constexpr (std::is_same<Storage, std::vector<value_type>>::value) {
+        out = std::move(m_data);
+    }
+    else {
+        out.assign(std::make_move_iterator(m_data.begin()), std::make_move_iterator(m_data.end()));
+    }
+    m_data.clear();
+}
+
+// Private Function /////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @details
+ * # 演算法
+ * 用一個 frontier（以值排序的 heap）做 best-first search，每次取出 frontier 中最「小」的節點，第 k 次取出的就是答案。
+ * 一個節點只要在「小於等於」它的節點被取出後才加入 frontier，就不會太早或太晚被取出。
+ * 
+ * ## 找第 k 小
+ * 從 min heap 的根開始。取出 min heap 中的節點 m 時：
+ * - 加入 m 的兩個子節點（min heap 由上而下遞增）。
+ * - 加入 m 的對應節點（性質3保證 m <= 對應節點）。max heap 中的每個節點都有存在的對應節點，所以都會被加入，而且不需要展開。
+ * 
+ * ## 找第 k 大
+ * 從 max heap 的根開始。取出 max heap 中的節點 M 時：
+ * - 加入 M 的兩個子節點。
+ * - 加入 min heap 中「safeCorrespond 為 M」的節點，也就是 M 的對應節點，以及「M 不存在的子節點」所對應的節點。
+ *   min heap 中的節點不需要展開。
+ */
+template<typename T, typename Storage>
+typename GenericDeap<T, Storage>::value_type GenericDeap<T, Storage>::kthElement(size_t k, bool smallest) const
+{
+    using namespace Deap_Trait;
+
+    std::function<bool(const value_type&, const value_type&)> _less;
+    if (smallest) _less = std::less<value_type>{};
+    else          _less = std::greater<value_type>{};
+
+    // std::push_heap 會把「最大」的放在最前面，所以比較時要反過來
+    auto later = [&](size_t a, size_t b) { return _less(m_data[b], m_data[a]); };
+
+    std::vector<size_t> frontier;
+    frontier.reserve(3 * k + 1);
+
+    auto add = [&](size_t id) {
+        if (!exist(id)) return;
+        frontier.push_back(id);
+        std::push_heap(frontier.begin(), frontier.end(), later);
+    };
+
+    // 只有一個元素時，max heap 是空的
+    if (!smallest && !exist(1)) add(0);
+    else                        add(smallest ? 0 : 1);
+
+    while (true) {
+        std::pop_heap(frontier.begin(), frontier.end(), later);
+        const size_t id = frontier.back();
+        frontier.pop_back();
+
+        if (--k == 0) return m_data[id];
+
+        // 另一個 heap 中的節點不需要展開
+        if (inMinHeap(id) != smallest) continue;
+
+        const size_t L = leftChild(id), R = rightChild(id);
+        add(L);
+        add(R);
+        add(correspond(id));
+
+        if (!smallest) {
+            if (!exist(L)) add(correspond(L));
+            if (!exist(R)) add(correspond(R));
+        }
+    }
+}
+
+/**
+ * @details
+ * # 演算法
+ * 1. 首先做一般的heapify。對於min heap中的節點，將較大的值向下推；對於max heap中的節點，將較小的值向下推。  
+ *    使得左子樹為min heap，右子樹為max heap。
+ * 2. 對於每個葉子節點，每當min heap中對應的節點 > max heap中對應的節點，則交換兩節點的值，並分別對兩個節點pullUp。
+ * 
+ * 這演算法是自己想的，但經過unit test後，我覺得應該是對的。
+ * 
+ * # 步驟2是如何確保條件3成立的
+ * 
+ * 基本想法是從min heap和max heap中各取一條從「根節點」到「葉節點」的path：
+ * > m1, m2, ..., mi
+ * 和
+ * > M1, M2, ..., Mj
+ * 其中mi的對應節點為Mj，接下來就要將兩條path上的節點給排序，使得`m1 <= m2 <= ... <= mi <= Mj <= ... <= M2 <= M1`。
+ * 因為 m1 ~ mi 和 Mj ~ M1 已經是遞增的，所以只要當 mi > Mj 時，將兩節點的值交換然後分別對兩條 path 排序（使用 pullUp）。
+ * 重覆直到 mi <= Mj。
+ *
+ * # 已經排序的輸入
+ * 掃描一次 m_data 計算排序程度（Sortedness_Trait::sortedness）。遞增或遞減的輸入直接用 layoutSorted() 擺放；
+ * 只有少數幾個遞增 run 的輸入先合併成遞增再擺放。其他的才做上面的步驟。
+ */
+template<typename T, typename Storage>
+void GenericDeap<T, Storage>::buildDeap()
+{
+    using namespace Deap_Trait;
+    using namespace Sortedness_Trait;
+
+    if (m_data.size() < 2) return;
+
+    const Sortedness s = sortedness(m_data);
+    if (s.descents == 0) { layoutSorted(true);  return; }
+    if (!s.hasAscent)    { layoutSorted(false); return; }
+    if (s.descents < MAX_RUNS) {
+        mergeRuns(m_data, s);
+        layoutSorted(true);
+        return;
+    }
+
+    // 一般的heapify
+    for (size_t i = parent(m_data.size() - 1); i != static_cast<size_t>(-1); --i) {
+        pushDown(i);
+    }
+
+    // 對每個葉節點
+    for (size_t i = m_data.size() - 1; isLeaf(i); --i) {
+        size_t minHeapNode = i;
+        size_t maxHeapNode = safeCorrespond(i);
+
+        // 對調，使得 minHeapNode 在 min heap 內
+        if (!inMinHeap(minHeapNode)) std::swap(minHeapNode, maxHeapNode);
+
+        // 如果 min heap 中的節點較大
+        while (m_data[minHeapNode] > m_data[maxHeapNode]) {
+            std::swap(m_data[minHeapNode], m_data[maxHeapNode]);
+            pullUp(minHeapNode);
+            pullUp(maxHeapNode);
+        }
+    }
+}
+
+/**
+ * @details
+ * # 演算法
+ * 依 index 的順序擺放：min heap 的節點依序拿剩下最小的值，max heap 的節點依序拿剩下最大的值。
+ * - min heap 中所有的值都小於等於 max heap 中所有的值，所以條件3一定成立
+ * - 同一個 heap 中，父節點的 index 比子節點小、比較早拿，所以 min heap 由上往下遞增，max heap 由上往下遞減
+ *
+ * 每一層的前半是 min heap、後半是 max heap。第 i 個節點拿的是排序後的第幾個值，可以從它前面有幾個 min heap 的節點直接算出來，
+ * 所以用 Sortedness_Trait::permute 原地搬移，不需要第二份 m_data。
+ */
+template<typename T, typename Storage>
+void GenericDeap<T, Storage>::layoutSorted(bool ascending)
+{
+    const size_t n = m_data.size();
+
+    Sortedness_Trait::permute(m_data, [n, ascending](size_t i) {
+        // 第 level 層（從 0 開始）的起點為 2^(level+1) - 2，前 2^level 個節點在 min heap
+        const size_t level = Sortedness_Trait::floorLog2(i + 2) - 1;
+        const size_t half = size_t(1) << level;
+        const size_t offset = i - (2 * half - 2);
+        const bool minHeap = offset < half;
+
+        // 上面每一層各有 1、2、4……個 min heap 的節點
+        const size_t minBefore = half - 1 + (minHeap ? offset : half);
+
+        // 遞增時最小的值在前面，遞減時在後面
+        const size_t taken = minHeap ? minBefore : i - minBefore;
+        return minHeap == ascending ? taken : n - 1 - taken;
+    });
+}
+
+/**
+ * @details 這操作在 push 和 pop 都會用到
+ * # 演算法
+ * 對於新插入的葉節點 id，將它和「對應節點」比較大小。
+ * - 如果滿足性質3的大小要求，則直接對 id pullUp()。
+ * - 否則，交換兩節點的值，然後對「對應節點」 pullUp()。
+ */
+template<typename T, typename Storage>
+void GenericDeap<T, Storage>::insert(const size_t id)
+{
+    using namespace Deap_Trait;
+
+    assert(isLeaf(id));
+    if (id == 0) return;
+
+    // N -> node
+    size_t minN = id, maxN = safeCorrespond(id);
+    if (!inMinHeap(minN)) std::swap(minN, maxN);
+
+    /**
+    * @note
+    * Edge Case: id 在 max heap，但它直接對應的節點不是 leaf。不過對應節點只有一個子節點，所以直接取它的子節點
+    * > 可能發生的情境： popMax
+    */
+    if (!isLeaf(minN) && !exist(rightChild(minN))) minN = leftChild(minN);
+
+    if (isLeaf(minN)) {
+        if (m_data[minN] <= m_data[maxN]) { // 葉節點的大小滿足規定，只需對id所在的heap排序
+            pullUp(id);                     // 若 id 的值被往上移，葉節點的性質3還是被保留
+        }
+        else {
+            std::swap(m_data[minN], m_data[maxN]); // 交換使葉節點滿足規定
+            pullUp(safeCorrespond(id));
+        }
+    }
+    /**
+     * @note
+     * Edge Case: id在max heap，而且min heap中有兩個「葉節點」和其對應
+     * > 可能發生情境：popMax.
+     * > 
+     * > 此時要拿id和兩個葉節點比較
+     * > - 如果 id 節點的值較大，則 pullUp(id)。
+     * > - 否則要拿較大的葉節點和id互換，然後對葉節點 pullUp。
+     */
+    else {
+        assert(maxN == id);
+        const size_t minLeaf1 = leftChild(minN), minLeaf2 = rightChild(minN);
+
+        // 如果 id >= 另兩個對應的葉節點，只要將id向上拉
+        if (m_data[minLeaf1] <= m_data[id] && m_data[minLeaf2] <= m_data[id]) {
+            pullUp(id);
+        }
+        // 否則，從 minLeaf1 和 minLeaf2 取較大的值和 id 互換，然後排序min heap
+        else if (m_data[minLeaf1] > m_data[minLeaf2]) {
+            std::swap(m_data[minLeaf1], m_data[id]);
+            pullUp(minLeaf1);
+        }
+        else {
+            std::swap(m_data[minLeaf2], m_data[id]);
+            pullUp(minLeaf2);
+        }
+    }
+}
+
+// 基礎操作 /////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @details
+ */
+template<typename T, typename Storage>
+void GenericDeap<T, Storage>::pullUp(size_t id)
+{
+    using namespace Deap_Trait;
+
+    std::function<bool(const value_type&, const value_type&)> _less;
+    if (inMinHeap(id)) _less = std::less<value_type>{};
+    else               _less = std::greater<value_type>{};
+
+    while (exist(id)) {
+        // Note: id = 0, 1 時為 heap 的根，此時 p == id。然後因為沒有比父節點「小」，所以就break。
+        size_t p = parent(id);
+
+        // 如果比父節點「小」，則要往上移
+        if (_less(m_data[id], m_data[p])) {
+            std::swap(m_data[id], m_data[p]);
+            // 繼續pullUp
+            id = p;
+        }
+        else
+            break;
+    }
+}
+
+/**
+ * @details 和一般的heapify一樣
+ */
+template<typename T, typename Storage>
+void GenericDeap<T, Storage>::pushDown(size_t id)
+{
+    using namespace Deap_Trait;
+
+    std::function<bool(const value_type&, const value_type&)> _less;
+    if (inMinHeap(id)) _less = std::less<value_type>{};
+    else               _less = std::greater<value_type>{};
+
+    while (exist(id)) {
+        size_t _minNode = id;
+        const size_t L = leftChild(id), R = rightChild(id);
+
+        // 找到最「小」的節點
+        if (exist(L) && _less(m_data[L], m_data[_minNode]))
+            _minNode = L;
+        if (exist(R) && _less(m_data[R], m_data[_minNode]))
+            _minNode = R;
+
+        // 不用再繼續
+        if (_minNode == id) return;
+
+        // 將最「小」的節點往上移
+        std::swap(m_data[id], m_data[_minNode]);
+        // 繼續pushDown
+        id = _minNode;
+    }
+}
+
+// Debug /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef NDEBUG
+
+template<typename T, typename Storage>
+bool GenericDeap<T, Storage>::verify() const
+{
+    using namespace Deap_Trait;
+
+    if (m_data.size() < 2) return true;
+    
+    // for each node
+    for (size_t i = 0; i < m_data.size(); ++i) {
+        const size_t L = leftChild(i), R = rightChild(i);
+
+        if (inMinHeap(i)) {
+            if (exist(L) && m_data[i] > m_data[L]) 
+                return false;
+            if (exist(R) && m_data[i] > m_data[R]) 
+                return false;
+            if (m_data[i] > m_data[safeCorrespond(i)])
+                return false;
+        }
+        else {
+            if (exist(L) && m_data[i] < m_data[L]) 
+                return false;
+            if (exist(R) && m_data[i] < m_data[R]) 
+                return false;
+            if (m_data[i] < m_data[safeCorrespond(i)]) 
+                return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename T, typename Storage>
+void GenericDeap<T, Storage>::printData() const
+{
+    std::cerr << "Deap::m_data = \n\t";
+    for (value_type num : m_data) {
+        std::cerr << num << ' ';
+    }
+    std::cerr.put('\n');
+}
+#endif
+
 #endif // DEAP_H
+
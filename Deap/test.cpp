@@ -1,5 +1,6 @@
 #include "Deap.h"
 #include "gtest/gtest.h"
+#include <algorithm>
 
 TEST(Deap, ParentTest) {
     using Deap_Trait::parent;
@@ -170,4 +171,135 @@ TEST(Deap, pop) {
             max = x;
         }
     }
-}
\ No newline at end of file
+}
+TEST(Deap, kth) {
+    std::vector<int> arr;
+
+    unsigned seed = rand();
+    srand(seed);
+    std::cerr << "Random seed = " << seed << '\n';
+
+    for (size_t i = 0; i < 100; ++i) {
+        arr.push_back(rand() % 10);
+        const Deap tmp(arr.begin(), arr.end());
+
+        std::vector<int> sorted(arr);
+        std::sort(sorted.begin(), sorted.end());
+
+        for (size_t k = 1; k <= sorted.size(); ++k) {
+            ASSERT_TRUE(tmp.kthSmallest(k) == sorted[k - 1]);
+            ASSERT_TRUE(tmp.kthLargest(k) == sorted[sorted.size() - k]);
+        }
+
+        ASSERT_THROW(tmp.kthSmallest(0), std::out_of_range);
+        ASSERT_THROW(tmp.kthLargest(sorted.size() + 1), std::out_of_range);
+    }
+}
+
+TEST(Deap, drainSorted) {
+    std::vector<int> vec, sorted, out;
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(rand() % 10);
+        sorted = vec;
+        std::sort(sorted.begin(), sorted.end());
+
+        Deap asc(vec.begin(), vec.end());
+        asc.drainSorted(out);
+        ASSERT_TRUE(asc.size() == 0);
+        ASSERT_TRUE(out == sorted);
+
+        Deap desc(vec.begin(), vec.end());
+        desc.drainSorted(out, false);
+        ASSERT_TRUE(desc.size() == 0);
+        ASSERT_TRUE(std::equal(out.rbegin(), out.rend(), sorted.begin(), sorted.end()));
+
+        // 取出後還可以繼續使用
+        desc.push(3);
+        ASSERT_TRUE(desc.popMax() == 3 && desc.size() == 0);
+    }
+}
+
+TEST(Deap, peek) {
+    Deap tmp;
+    ASSERT_THROW(tmp.peekMin(), std::out_of_range);
+    ASSERT_THROW(tmp.peekMax(), std::out_of_range);
+
+    tmp = randomDeap(100);
+
+    while (tmp.size()) {
+        const int min = tmp.peekMin(), max = tmp.peekMax();
+        if (rand() & 1) ASSERT_TRUE(tmp.popMin() == min);
+        else            ASSERT_TRUE(tmp.popMax() == max);
+    }
+}
+
+TEST(Deap, negative) {
+    // pullUp、pushDown 以前用 size_t 比較大小，負數會被當成很大的數
+    Deap tmp;
+    for (int i = 0; i < 100; ++i) tmp.push(rand() % 10 - 5);
+    ASSERT_TRUE(tmp.verify());
+
+    int min = INT_MIN;
+    while (tmp.size()) {
+        int x = tmp.popMin();
+        ASSERT_TRUE(x >= min);
+        ASSERT_TRUE(tmp.verify());
+        min = x;
+    }
+}
+
+TEST(Deap, pushRange) {
+    unsigned seed = rand();
+    srand(seed);
+    std::cerr << "Random seed = " << seed << '\n';
+
+    // 小批次會一個一個 push，大批次會重建
+    for (size_t batch : {1, 5, 100, 1000}) {
+        Deap tmp;
+        std::vector<int> vec;
+
+        for (int round = 0; round < 5; ++round) {
+            vec.clear();
+            for (size_t i = 0; i < batch; ++i) vec.push_back(rand() % 10);
+            tmp.pushRange(vec.begin(), vec.end());
+            ASSERT_TRUE(tmp.verify());
+        }
+        ASSERT_TRUE(tmp.size() == 5 * batch);
+    }
+}
+
+TEST(Deap, sortedInput) {
+    // 遞增、遞減、全部一樣、少數幾個 run、很多 run（走 heapify）
+    auto shapes = [](size_t n) {
+        std::vector<std::vector<int>> res(6);
+        for (size_t i = 0; i < n; ++i) {
+            res[0].push_back(int(i));
+            res[1].push_back(int(n - i));
+            res[2].push_back(7);
+            res[3].push_back(int(i % (n / 2 + 1)));
+            res[4].push_back(int(i % (n / 3 + 1)));
+            res[5].push_back(int(i % 5));
+        }
+        return res;
+    };
+
+    for (size_t n = 0; n < 100; ++n) {
+        for (auto& vec : shapes(n)) {
+            std::vector<int> sorted = vec;
+            std::sort(sorted.begin(), sorted.end());
+
+            Deap tmp(vec.begin(), vec.end());
+            ASSERT_TRUE(tmp.verify());
+
+            for (size_t lo = 0, hi = n; lo < hi; ) {
+                if ((lo + hi) & 1) ASSERT_TRUE(tmp.popMin() == sorted[lo++]);
+                else               ASSERT_TRUE(tmp.popMax() == sorted[--hi]);
+                ASSERT_TRUE(tmp.verify());
+            }
+        }
+    }
+}
@@ -0,0 +1,161 @@
+/**
+ * @file EdgeHeap.h
+ * @brief 在 heap 前面放兩個小的排序緩衝區，存放最小的 k 個和最大的 k 個值，適合連續從同一端取出的情況
+ */
+#ifndef EDGEHEAP_H
+#define EDGEHEAP_H
+
+#include "MinMaxHeap.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+
+/**
+ * @brief 兩端各有一個排序緩衝區的 double-ended priority queue
+ * @tparam T - 元素的型別，需要支援 `<`、`>`、`==`
+ * @tparam Heap - 存放中間的值的 heap 樣板，例如 BasicMinMaxHeap 或 BasicDeap
+ * @details
+ * 元素分成三部分，並維持 m_low 的值 <= m_heap 的值 <= m_high 的值：
+ * - m_low：最小的一些值，由大到小排列，最小值在尾端
+ * - m_heap：中間的值
+ * - m_high：最大的一些值，由小到大排列，最大值在尾端
+ *
+ * 兩個緩衝區最多各有 edge 個值：
+ * - popMin、popMax 直接從緩衝區的尾端取出，O(1)。緩衝區空了才從 heap 一次取出 edge 個補滿；
+ *   heap 也空了就把另一個緩衝區靠近這一端的一半搬過來。攤銷後每次 pop 的成本和 heap 相同，
+ *   但連續的 pop 只會集中在補充的時候碰到 heap。
+ * - peekMin、peekMax 不會補充緩衝區，O(1)
+ * - push 的值落在兩個緩衝區之間時，直接放進 heap；比 m_low 最大的值還小時插入 m_low（O(edge)），
+ *   m_low 滿了就把它最大的值移到 heap，m_high 亦同
+ */
+template<typename T, template<typename> class Heap = BasicMinMaxHeap>
+class EdgeHeap {
+public:
+    typedef T value_type;
+
+private:
+    std::vector<value_type> m_low;
+    Heap<value_type> m_heap;
+    std::vector<value_type> m_high;
+    size_t m_edge;
+
+public:
+    /// @brief 建立空的 EdgeHeap
+    /// @param edge - 每個緩衝區最多存放幾個值
+    /// @throw std::invalid_argument - 如果 edge 為 0
+    explicit EdgeHeap(size_t edge = 64) : m_edge(edge) {
+        if (edge == 0) throw std::invalid_argument("EdgeHeap - edge must be positive");
+        m_low.reserve(edge);
+        m_high.reserve(edge);
+    }
+
+    /// @brief 從 [first, last) 建立 EdgeHeap，所有值先放進 heap，緩衝區在第一次 pop 時才補充
+    /// @tparam InputIt - 滿足 input iterator
+    /// @param first - 範圍的起點（包含）
+    /// @param last - 範圍的終點（不包含）
+    /// @param edge - 每個緩衝區最多存放幾個值
+    /// @throw std::invalid_argument - 如果 edge 為 0
+    template<typename InputIt>
+    EdgeHeap(InputIt first, InputIt last, size_t edge = 64) : EdgeHeap(edge) {
+        m_heap = Heap<value_type>(first, last);
+    }
+
+    /// @brief 插入 value
+    void push(value_type value) {
+        if (!m_low.empty() && value < m_low.front()) {
+            if (m_low.size() == m_edge) {
+                m_heap.push(std::move(m_low.front()));
+                m_low.erase(m_low.begin());
+            }
+            auto it = std::upper_bound(m_low.begin(), m_low.end(), value, [](const value_type& a, const value_type& b) { return a > b; });
+            m_low.insert(it, std::move(value));
+        }
+        else if (!m_high.empty() && value > m_high.front()) {
+            if (m_high.size() == m_edge) {
+                m_heap.push(std::move(m_high.front()));
+                m_high.erase(m_high.begin());
+            }
+            auto it = std::upper_bound(m_high.begin(), m_high.end(), value, [](const value_type& a, const value_type& b) { return a < b; });
+            m_high.insert(it, std::move(value));
+        }
+        else {
+            m_heap.push(std::move(value));
+        }
+    }
+
+    /// @brief 移除最小值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMin() {
+        if (m_low.empty()) refill(m_low, m_high, true);
+        if (m_low.empty()) throw std::out_of_range("EdgeHeap::popMin - no element");
+
+        value_type ret = std::move(m_low.back());
+        m_low.pop_back();
+        return ret;
+    }
+
+    /// @brief 移除最大值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMax() {
+        if (m_high.empty()) refill(m_high, m_low, false);
+        if (m_high.empty()) throw std::out_of_range("EdgeHeap::popMax - no element");
+
+        value_type ret = std::move(m_high.back());
+        m_high.pop_back();
+        return ret;
+    }
+
+    /// @brief 回傳最小值，不移除
+    /// @throw std::out_of_range - 如果為空
+    const value_type& peekMin() const {
+        if (!m_low.empty())      return m_low.back();
+        if (m_heap.size() != 0)  return m_heap.peekMin();
+        if (!m_high.empty())     return m_high.front();
+        throw std::out_of_range("EdgeHeap::peekMin - no element");
+    }
+
+    /// @brief 回傳最大值，不移除
+    /// @throw std::out_of_range - 如果為空
+    const value_type& peekMax() const {
+        if (!m_high.empty())     return m_high.back();
+        if (m_heap.size() != 0)  return m_heap.peekMax();
+        if (!m_low.empty())      return m_low.front();
+        throw std::out_of_range("EdgeHeap::peekMax - no element");
+    }
+
+    /// 有幾個元素
+    size_t size() const { return m_low.size() + m_heap.size() + m_high.size(); }
+
+    /// 每個緩衝區最多存放幾個值
+    size_t edge() const { return m_edge; }
+
+private:
+    /**
+     * @brief 補充空的緩衝區 buffer
+     * @param buffer - 要補充的緩衝區，呼叫時為空
+     * @param other - 另一端的緩衝區
+     * @param min - `true`，buffer 是 m_low；`false`，buffer 是 m_high
+     * @details
+     * heap 不是空的：從 heap 同一端取出最多 edge 個。取出的順序是由外往內，所以反轉後最外側的值在尾端。
+     * heap 是空的：所有值都在 other，把 other 靠近這一端的一半（至少一個）搬過來。
+     * 只搬一半，交錯 popMin、popMax 時才不會每次都把整個緩衝區搬來搬去。
+     */
+    void refill(std::vector<value_type>& buffer, std::vector<value_type>& other, bool min) {
+        if (m_heap.size() != 0) {
+            const size_t n = std::min(m_edge, m_heap.size());
+            for (size_t i = 0; i < n; ++i) buffer.push_back(min ? m_heap.popMin() : m_heap.popMax());
+            std::reverse(buffer.begin(), buffer.end());
+            return;
+        }
+
+        // other 的開頭是靠近這一端的值，順序和 buffer 相反
+        const size_t n = (other.size() + 1) / 2;
+        buffer.assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.begin() + n));
+        std::reverse(buffer.begin(), buffer.end());
+        other.erase(other.begin(), other.begin() + n);
+    }
+};
+
+#endif // EDGEHEAP_H
@@ -0,0 +1,66 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 EdgeHeap 和單獨的 MinMaxHeap、Deap 在「連續從同一端取出」時的速度
+ */
+#include "EdgeHeap.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include <random>
+#include <string>
+#include <vector>
+
+static const size_t N = 1 << 18;     ///< 一開始的元素數量
+static const size_t BURST = 256;     ///< 每一輪連續 pop 幾次
+static const size_t ROUNDS = 1 << 12;
+
+/**
+ * @brief 每一輪先 push BURST 個隨機值，接著 BURST 次「push 一個值再 popMin」，最後連續 popMax BURST 次
+ * @param hot - `true`，popMin 前 push 的值落在剛取出的最小值附近（例如即將到期的計時器）；`false`，push 隨機值
+ * @tparam Make - 建立 heap 的 callable
+ */
+template<typename Make>
+void run(const char* name, bool hot, Make make) {
+    std::mt19937 rng(1);
+    std::vector<int> values(N);
+    for (int& v : values) v = static_cast<int>(rng() >> 1);
+
+    auto heap = make(values.begin(), values.end());
+
+    long long sum = 0;
+    int lastMin = 0;
+    double seconds = Benchmark::measure([&] {
+        for (size_t r = 0; r < ROUNDS; ++r) {
+            for (size_t i = 0; i < BURST; ++i) heap.push(static_cast<int>(rng() >> 1));
+            for (size_t i = 0; i < BURST; ++i) {
+                heap.push(hot ? lastMin + static_cast<int>(rng() % 65536) : static_cast<int>(rng() >> 1));
+                lastMin = heap.popMin();
+                sum += lastMin;
+            }
+            for (size_t i = 0; i < BURST; ++i) sum += heap.popMax();
+        }
+    });
+    Benchmark::keep(sum);
+    Benchmark::report(name, ROUNDS * 4 * BURST, seconds);
+}
+
+/// 以兩種 push 的分布比較所有 heap
+void section(bool hot) {
+    typedef std::vector<int>::iterator It;
+    printf("\nn = %zu, bursts of %zu pops, %s pushes\n", N, BURST, hot ? "hot (near the minimum)" : "random");
+
+    run("MinMaxHeap", hot, [](It f, It l) { return MinMaxHeap(f, l); });
+    run("Deap", hot, [](It f, It l) { return Deap(f, l); });
+    for (size_t edge : {16, 64, 256}) {
+        std::string name = "EdgeHeap<MinMaxHeap>, edge = " + std::to_string(edge);
+        run(name.c_str(), hot, [edge](It f, It l) { return EdgeHeap<int>(f, l, edge); });
+        name = "EdgeHeap<Deap>, edge = " + std::to_string(edge);
+        run(name.c_str(), hot, [edge](It f, It l) { return EdgeHeap<int, BasicDeap>(f, l, edge); });
+    }
+}
+
+int main() {
+    section(false);
+    section(true);
+    return 0;
+}
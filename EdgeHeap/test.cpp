@@ -0,0 +1,93 @@
+#include "EdgeHeap.h"
+#include "Depq.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+static_assert(Depq_Trait::isDepq<EdgeHeap<int>> && Depq_Trait::isDepq<EdgeHeap<int, BasicDeap>>, "EdgeHeap should satisfy the DEPQ interface");
+
+TEST(EdgeHeap, basic) {
+    ASSERT_THROW(EdgeHeap<int>(0), std::invalid_argument);
+
+    EdgeHeap<int> heap(2);
+    ASSERT_THROW(heap.popMin(), std::out_of_range);
+    ASSERT_THROW(heap.peekMax(), std::out_of_range);
+
+    for (int v : {5, 3, 8, 1, 9, 7, 2}) heap.push(v);
+    ASSERT_TRUE(heap.size() == 7);
+    ASSERT_TRUE(heap.peekMin() == 1 && heap.peekMax() == 9);
+
+    ASSERT_TRUE(heap.popMin() == 1);
+    ASSERT_TRUE(heap.popMin() == 2);
+    ASSERT_TRUE(heap.popMax() == 9);
+
+    // 小於緩衝區最大值的 0 插入 m_low；4 落在中間，放進 heap
+    heap.push(0);
+    heap.push(4);
+    ASSERT_TRUE(heap.popMin() == 0);
+    ASSERT_TRUE(heap.popMin() == 3);
+    ASSERT_TRUE(heap.popMin() == 4);
+    ASSERT_TRUE(heap.popMax() == 8);
+    ASSERT_TRUE(heap.popMax() == 7);
+    ASSERT_TRUE(heap.popMax() == 5);
+    ASSERT_TRUE(heap.size() == 0);
+
+    std::vector<int> values{4, 6, 2};
+    EdgeHeap<int, BasicDeap> fromRange(values.begin(), values.end(), 1);
+    ASSERT_TRUE(fromRange.peekMax() == 6);
+}
+
+/// 和 std::multiset 比較：一段時間連續 popMin，再連續 popMax，中間穿插 push
+template<template<typename> class Heap>
+void burstTest(size_t edge) {
+    EdgeHeap<int, Heap> heap(edge);
+    std::multiset<int> expected;
+    std::mt19937 rng(static_cast<unsigned>(edge));
+
+    for (int round = 0; round < 200; ++round) {
+        const int pushes = rng() % 40;
+        for (int i = 0; i < pushes; ++i) {
+            const int v = rng() % 100;
+            heap.push(v);
+            expected.insert(v);
+        }
+
+        const bool min = rng() % 2;
+        const size_t pops = std::min<size_t>(rng() % 30, expected.size());
+        for (size_t i = 0; i < pops; ++i) {
+            ASSERT_TRUE(heap.peekMin() == *expected.begin());
+            ASSERT_TRUE(heap.peekMax() == *expected.rbegin());
+            if (min || i % 3 == 0) {
+                ASSERT_TRUE(heap.popMin() == *expected.begin());
+                expected.erase(expected.begin());
+            }
+            else {
+                ASSERT_TRUE(heap.popMax() == *expected.rbegin());
+                expected.erase(std::prev(expected.end()));
+            }
+            ASSERT_TRUE(heap.size() == expected.size());
+        }
+    }
+
+    // 全部取出，會用到從另一個緩衝區搬一半過來的路徑
+    while (!expected.empty()) {
+        ASSERT_TRUE(heap.popMax() == *expected.rbegin());
+        expected.erase(std::prev(expected.end()));
+        if (expected.empty()) break;
+        ASSERT_TRUE(heap.popMin() == *expected.begin());
+        expected.erase(expected.begin());
+    }
+    ASSERT_TRUE(heap.size() == 0);
+}
+
+TEST(EdgeHeap, bursts) {
+    for (size_t edge : {1, 2, 8, 64}) {
+        burstTest<BasicMinMaxHeap>(edge);
+        burstTest<BasicDeap>(edge);
+    }
+}
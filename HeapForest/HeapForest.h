@@ -0,0 +1,274 @@
+/**
+ * @file HeapForest.h
+ * @brief 把大量的小 heap 存在同一塊 arena 中的容器，用整數 id 存取
+ */
+#ifndef HEAPFOREST_H
+#define HEAPFOREST_H
+
+#include "MinMaxHeap.h"
+#include <assert.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 指向 arena 中一個區塊的 view，提供 GenericMinMaxHeap、GenericDeap 的 push、pop 用到的 vector 介面
+ * @details 不會配置記憶體：大小存在外部（HeapForest 的 Header），容量由呼叫端保證足夠
+ */
+template<typename T>
+class ArenaSpan {
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+private:
+    T* m_data = nullptr;
+    uint32_t* m_size = nullptr;
+    uint32_t m_capacity = 0;
+
+public:
+    ArenaSpan() = default;
+    ArenaSpan(T* data, uint32_t* size, uint32_t capacity) : m_data(data), m_size(size), m_capacity(capacity) {}
+
+    size_t size() const { return *m_size; }
+    bool empty() const { return *m_size == 0; }
+
+    T& operator[](size_t id) { return m_data[id]; }
+    const T& operator[](size_t id) const { return m_data[id]; }
+
+    T& front() { return m_data[0]; }
+    const T& front() const { return m_data[0]; }
+    T& back() { return m_data[*m_size - 1]; }
+    const T& back() const { return m_data[*m_size - 1]; }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + *m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + *m_size; }
+
+    void push_back(T value) {
+        assert(*m_size < m_capacity);
+        m_data[(*m_size)++] = std::move(value);
+    }
+
+    void pop_back() {
+        assert(*m_size != 0);
+        m_data[--*m_size] = T();
+    }
+};
+
+/**
+ * @brief 很多個 double-ended priority queue 共用一塊 arena
+ * @tparam T - 元素的型別，需要支援 `<`、`>`、`==`，而且要有 default constructor
+ * @tparam Generic - heap 的演算法，GenericMinMaxHeap 或 GenericDeap
+ * @details
+ * 每個 heap 只有一個 12 byte 的 Header（在 arena 中的位置、大小、size class），元素存在共用的 m_arena：
+ * - 區塊的容量是 2 的次方（size class）。heap 滿了就換到大一級的區塊，剩不到 1/4 就換到小一級的區塊，變成空的就歸還區塊
+ * - 歸還的區塊放進同一個 size class 的 free list，之後優先重複使用；不會合併，所以 size 變化很大時可以呼叫 shrinkToFit() 重新排列
+ * - 每次操作時用 ArenaSpan 包住 heap 的區塊，交給 Generic 執行原本的 push、pop 演算法
+ *
+ * id 從 0 開始連續編號，push 到不存在的 id 時會自動增加 heap 的數量。
+ */
+template<typename T, template<typename, typename> class Generic = GenericMinMaxHeap>
+class HeapForest {
+public:
+    typedef T value_type;
+
+private:
+    typedef Generic<T, ArenaSpan<T>> View;
+
+    /// 最小的區塊容量為 2^MIN_CLASS
+    static constexpr uint8_t MIN_CLASS = 1;
+    /// size class 的數量，區塊容量最大為 2^(CLASSES - 1)
+    static constexpr uint8_t CLASSES = 32;
+    /// 沒有區塊
+    static constexpr uint8_t NO_BLOCK = 0xFF;
+
+    struct Header {
+        uint32_t m_offset = 0;
+        uint32_t m_size = 0;
+        uint8_t m_class = NO_BLOCK;
+    };
+
+    std::vector<T> m_arena;
+    std::vector<Header> m_heaps;
+    /// 每個 size class 可以重複使用的區塊位置
+    std::vector<uint32_t> m_free[CLASSES];
+    /// 所有 heap 的元素總數
+    size_t m_elements = 0;
+
+public:
+    /// @brief 建立 HeapForest
+    /// @param heaps - 一開始有幾個（空的）heap
+    explicit HeapForest(size_t heaps = 0) : m_heaps(heaps) {}
+
+    /// @brief 把 value 插入第 id 個 heap，id 超過目前的數量時自動增加
+    /// @throw std::length_error - 如果 arena 超過 2^32 個元素
+    void push(size_t id, value_type value) {
+        if (id >= m_heaps.size()) m_heaps.resize(id + 1);
+
+        Header& h = m_heaps[id];
+        if (h.m_class == NO_BLOCK) move(h, MIN_CLASS);
+        else if (h.m_size == capacity(h.m_class)) move(h, h.m_class + 1);
+
+        view(h).push(std::move(value));
+        ++m_elements;
+    }
+
+    /// @brief 移除第 id 個 heap 的最小值並回傳
+    /// @throw std::out_of_range - 如果 id 不存在或 heap 為空
+    value_type popMin(size_t id) {
+        Header& h = checked(id, "HeapForest::popMin - no element");
+        value_type ret = view(h).popMin();
+        shrink(h);
+        return ret;
+    }
+
+    /// @brief 移除第 id 個 heap 的最大值並回傳
+    /// @throw std::out_of_range - 如果 id 不存在或 heap 為空
+    value_type popMax(size_t id) {
+        Header& h = checked(id, "HeapForest::popMax - no element");
+        value_type ret = view(h).popMax();
+        shrink(h);
+        return ret;
+    }
+
+    /// @brief 回傳第 id 個 heap 的最小值，不移除
+    /// @throw std::out_of_range - 如果 id 不存在或 heap 為空
+    const value_type& peekMin(size_t id) const {
+        return view(checked(id, "HeapForest::peekMin - no element")).peekMin();
+    }
+
+    /// @brief 回傳第 id 個 heap 的最大值，不移除
+    /// @throw std::out_of_range - 如果 id 不存在或 heap 為空
+    const value_type& peekMax(size_t id) const {
+        return view(checked(id, "HeapForest::peekMax - no element")).peekMax();
+    }
+
+    /// 第 id 個 heap 有幾個元素，id 不存在時為 0
+    size_t size(size_t id) const { return id < m_heaps.size() ? m_heaps[id].m_size : 0; }
+
+    /// 有幾個 heap（包含空的）
+    size_t heaps() const { return m_heaps.size(); }
+
+    /// 所有 heap 的元素總數
+    size_t elements() const { return m_elements; }
+
+    /// @brief 依 id 順序，對每個不是空的 heap 呼叫 `func(id, 最小值)`
+    /// @tparam Func - 接受 `(size_t, const value_type&)` 的 callable
+    template<typename Func>
+    void forEachMin(Func&& func) const {
+        for (size_t id = 0; id < m_heaps.size(); ++id) {
+            const Header& h = m_heaps[id];
+            if (h.m_size != 0) func(id, view(h).peekMin());
+        }
+    }
+
+    /// 佔用的記憶體（byte），包含 arena 中沒有使用的空間，不包含 free list
+    size_t memoryUsage() const {
+        return m_arena.capacity() * sizeof(value_type) + m_heaps.capacity() * sizeof(Header);
+    }
+
+    /// @brief 依 id 順序重新排列 arena，每個 heap 使用剛好放得下的 size class，並清空 free list
+    void shrinkToFit() {
+        size_t total = 0;
+        for (const Header& h : m_heaps) {
+            if (h.m_size != 0) total += capacity(fitClass(h.m_size));
+        }
+
+        std::vector<T> arena;
+        arena.reserve(total);
+        for (Header& h : m_heaps) {
+            if (h.m_size == 0) {
+                h.m_class = NO_BLOCK;
+                continue;
+            }
+            const uint8_t c = fitClass(h.m_size);
+            const uint32_t offset = static_cast<uint32_t>(arena.size());
+            for (uint32_t i = 0; i < h.m_size; ++i) arena.push_back(std::move(m_arena[h.m_offset + i]));
+            arena.resize(offset + capacity(c));
+            h.m_offset = offset;
+            h.m_class = c;
+        }
+
+        m_arena.swap(arena);
+        for (auto& f : m_free) f = std::vector<uint32_t>();
+    }
+
+private:
+    static uint32_t capacity(uint8_t c) { return uint32_t(1) << c; }
+
+    /// 放得下 n 個元素的最小 size class
+    static uint8_t fitClass(uint32_t n) {
+        uint8_t c = MIN_CLASS;
+        while (capacity(c) < n) ++c;
+        return c;
+    }
+
+    /// 用 ArenaSpan 包住 h 的區塊
+    View view(Header& h) {
+        return View::adopt(ArenaSpan<T>(m_arena.data() + h.m_offset, &h.m_size, capacity(h.m_class)));
+    }
+
+    /// 給 peek 使用的 view，只會讀取
+    const View view(const Header& h) const {
+        return const_cast<HeapForest*>(this)->view(const_cast<Header&>(h));
+    }
+
+    /// @brief 回傳第 id 個 heap 的 Header
+    /// @throw std::out_of_range - 如果 id 不存在或 heap 為空，訊息為 message
+    const Header& checked(size_t id, const char* message) const {
+        if (id >= m_heaps.size() || m_heaps[id].m_size == 0) throw std::out_of_range(message);
+        return m_heaps[id];
+    }
+
+    Header& checked(size_t id, const char* message) {
+        return const_cast<Header&>(static_cast<const HeapForest*>(this)->checked(id, message));
+    }
+
+    /// @brief 取得一個 size class 為 c 的區塊，優先使用 free list
+    /// @throw std::length_error - 如果 arena 超過 2^32 個元素
+    uint32_t allocate(uint8_t c) {
+        if (c >= CLASSES) throw std::length_error("HeapForest - heap too large");
+
+        std::vector<uint32_t>& f = m_free[c];
+        if (!f.empty()) {
+            const uint32_t offset = f.back();
+            f.pop_back();
+            return offset;
+        }
+
+        const size_t offset = m_arena.size();
+        if (offset + capacity(c) > UINT32_MAX) throw std::length_error("HeapForest - arena too large");
+        m_arena.resize(offset + capacity(c));
+        return static_cast<uint32_t>(offset);
+    }
+
+    /// @brief 把 h 的元素搬到 size class 為 c 的新區塊，歸還舊的區塊
+    void move(Header& h, uint8_t c) {
+        const uint32_t offset = allocate(c);
+        if (h.m_class != NO_BLOCK) {
+            for (uint32_t i = 0; i < h.m_size; ++i) m_arena[offset + i] = std::move(m_arena[h.m_offset + i]);
+            m_free[h.m_class].push_back(h.m_offset);
+        }
+        h.m_offset = offset;
+        h.m_class = c;
+    }
+
+    /// @brief pop 之後，空了就歸還區塊，剩不到 1/4 就換到小一級的區塊
+    void shrink(Header& h) {
+        --m_elements;
+        if (h.m_size == 0) {
+            m_free[h.m_class].push_back(h.m_offset);
+            h.m_class = NO_BLOCK;
+        }
+        else if (h.m_class > MIN_CLASS && h.m_size <= capacity(h.m_class) / 4) {
+            move(h, h.m_class - 1);
+        }
+    }
+};
+
+#endif // HEAPFOREST_H
@@ -0,0 +1,110 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 HeapForest 和 `std::unordered_map<key, MinMaxHeap>` 在大量小 heap 時的記憶體用量及速度
+ */
+#include "HeapForest.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include <cstddef>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <stdlib.h>
+
+/// 透過 operator new 配置、還沒釋放的位元組數（不含配置器本身的額外開銷）
+static size_t g_allocated = 0;
+
+/// 每塊記憶體前面多配置一個 header 記錄大小，釋放時才知道要扣掉多少
+static const size_t HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    char* p = static_cast<char*>(malloc(size + HEADER));
+    if (p == nullptr) throw std::bad_alloc();
+
+    *reinterpret_cast<size_t*>(p) = size;
+    g_allocated += size;
+    return p + HEADER;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) return;
+
+    char* p = static_cast<char*>(ptr) - HEADER;
+    g_allocated -= *reinterpret_cast<size_t*>(p);
+    free(p);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+static const size_t FILL = 4;  ///< 平均每個 heap 有幾個元素
+
+/// 每個 key 一個 MinMaxHeap，介面和 HeapForest 相同
+class MapOfHeaps {
+    std::unordered_map<size_t, MinMaxHeap> m_heaps;
+
+public:
+    void push(size_t id, int v) { m_heaps[id].push(v); }
+    int popMin(size_t id) { return m_heaps.find(id)->second.popMin(); }
+    int popMax(size_t id) { return m_heaps.find(id)->second.popMax(); }
+    size_t size(size_t id) const {
+        auto it = m_heaps.find(id);
+        return it == m_heaps.end() ? 0 : it->second.size();
+    }
+
+    template<typename Func>
+    void forEachMin(Func&& func) const {
+        for (auto& e : m_heaps) {
+            if (e.second.size() != 0) func(e.first, e.second.peekMin());
+        }
+    }
+};
+
+/**
+ * @brief heaps 個 heap：先隨機 push heaps * FILL 個值，再隨機 push、popMin、popMax heaps * FILL 次，最後走訪所有最小值
+ */
+template<typename Forest>
+void run(const char* name, size_t heaps) {
+    std::mt19937 rng(1);
+    const size_t before = g_allocated;
+
+    long long sum = 0;
+    {
+        Forest forest;
+        const double tPush = Benchmark::measure([&] {
+            for (size_t i = 0; i < heaps * FILL; ++i) forest.push(rng() % heaps, static_cast<int>(rng()));
+        });
+        const size_t bytes = g_allocated - before;
+
+        const double tMixed = Benchmark::measure([&] {
+            for (size_t i = 0; i < heaps * FILL; ++i) {
+                const size_t id = rng() % heaps;
+                const unsigned op = rng() % 3;
+                if (op == 0 || forest.size(id) == 0) forest.push(id, static_cast<int>(rng()));
+                else if (op == 1)                    sum += forest.popMin(id);
+                else                                 sum += forest.popMax(id);
+            }
+        });
+
+        const double tScan = Benchmark::measure([&] {
+            forest.forEachMin([&](size_t, int v) { sum += v; });
+        });
+
+        printf("%s, %zu heaps: %.1f bytes/heap\n", name, heaps, double(bytes) / heaps);
+        Benchmark::report("    push", heaps * FILL, tPush);
+        Benchmark::report("    push / popMin / popMax", heaps * FILL, tMixed);
+        Benchmark::report("    forEachMin", heaps, tScan);
+    }
+    Benchmark::keep(sum);
+}
+
+int main() {
+    for (size_t heaps : {size_t(1000000), size_t(10000000)}) {
+        run<MapOfHeaps>("unordered_map<key, MinMaxHeap>", heaps);
+        run<HeapForest<int>>("HeapForest<int>", heaps);
+        run<HeapForest<int, GenericDeap>>("HeapForest<int, GenericDeap>", heaps);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "HeapForest.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(HeapForest, basic) {
+    HeapForest<int> forest(2);
+    ASSERT_TRUE(forest.heaps() == 2 && forest.elements() == 0);
+    ASSERT_THROW(forest.popMin(0), std::out_of_range);
+    ASSERT_THROW(forest.peekMax(5), std::out_of_range);
+
+    for (int v : {5, 1, 9, 3}) forest.push(0, v);
+    forest.push(4, 7);
+    ASSERT_TRUE(forest.heaps() == 5 && forest.elements() == 5);
+    ASSERT_TRUE(forest.size(0) == 4 && forest.size(1) == 0 && forest.size(4) == 1 && forest.size(100) == 0);
+    ASSERT_TRUE(forest.peekMin(0) == 1 && forest.peekMax(0) == 9);
+    ASSERT_TRUE(forest.peekMin(4) == 7 && forest.peekMax(4) == 7);
+
+    std::vector<std::pair<size_t, int>> mins;
+    forest.forEachMin([&](size_t id, int v) { mins.emplace_back(id, v); });
+    ASSERT_TRUE((mins == std::vector<std::pair<size_t, int>>{{0, 1}, {4, 7}}));
+
+    ASSERT_TRUE(forest.popMin(0) == 1);
+    ASSERT_TRUE(forest.popMax(0) == 9);
+    ASSERT_TRUE(forest.popMax(4) == 7);
+    ASSERT_THROW(forest.popMin(4), std::out_of_range);
+    ASSERT_TRUE(forest.elements() == 2);
+}
+
+/// 和每個 id 各一個 std::multiset 比較，heap 的大小會反覆變大、變小，讓區塊換 size class 和重複使用
+template<template<typename, typename> class Generic>
+void randomTest() {
+    HeapForest<std::string, Generic> forest;
+    std::map<size_t, std::multiset<std::string>> expected;
+    std::mt19937 rng(11);
+
+    for (int i = 0; i < 30000; ++i) {
+        const size_t id = rng() % 40;
+        auto& s = expected[id];
+        const int op = rng() % 5;
+
+        // 每 5000 次操作中，前半段 push 比較多、後半段 pop 比較多
+        const bool growing = (i / 2500) % 2 == 0;
+        if (s.empty() || (growing ? op < 3 : op < 1)) {
+            const std::string v = std::to_string(rng() % 1000);
+            forest.push(id, v);
+            s.insert(v);
+        }
+        else if (op % 2) {
+            ASSERT_TRUE(forest.popMin(id) == *s.begin());
+            s.erase(s.begin());
+        }
+        else {
+            ASSERT_TRUE(forest.popMax(id) == *s.rbegin());
+            s.erase(std::prev(s.end()));
+        }
+        ASSERT_TRUE(forest.size(id) == s.size());
+
+        if (i % 7000 == 0) forest.shrinkToFit();
+    }
+
+    size_t total = 0;
+    for (auto& e : expected) total += e.second.size();
+    ASSERT_TRUE(forest.elements() == total);
+
+    forest.forEachMin([&](size_t id, const std::string& v) { ASSERT_TRUE(v == *expected[id].begin()); });
+    for (auto& e : expected) {
+        if (e.second.empty()) continue;
+        ASSERT_TRUE(forest.peekMin(e.first) == *e.second.begin());
+        ASSERT_TRUE(forest.peekMax(e.first) == *e.second.rbegin());
+    }
+}
+
+TEST(HeapForest, random) {
+    randomTest<GenericMinMaxHeap>();
+    randomTest<GenericDeap>();
+}
@@ -0,0 +1,149 @@
+/**
+ * @file IngestBuffer.h
+ * @brief 讓多個 producer thread 不用搶 mutex 就能把值交給單一 consumer thread 的 heap
+ */
+#ifndef INGESTBUFFER_H
+#define INGESTBUFFER_H
+
+#include "MinMaxHeap.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+
+/**
+ * @brief 多個 producer、單一 consumer 的 double-ended priority queue
+ * @tparam Heap - consumer 持有的 heap，需要提供 pushRange、popMin、popMax、peekMin、peekMax、size，例如 MinMaxHeap 或 Deap
+ * @details
+ * 每個 producer 有自己的 single-producer / single-consumer ring buffer：
+ * - producer 只寫 m_tail，consumer 只寫 m_head，所以不需要 lock，也不需要 compare-and-swap
+ * - m_head 和 m_tail 放在不同的 cache line，避免兩邊互相干擾
+ *
+ * consumer 在 popMin、popMax、peek、size 之前會呼叫 drain()，把所有 ring buffer 的內容一次交給 Heap::pushRange。
+ * 除了 registerProducer 之外，其他 consumer 端的函數只能由同一個 thread 呼叫。
+ */
+template<typename Heap = MinMaxHeap>
+class IngestBuffer {
+public:
+    typedef typename Heap::value_type value_type;
+
+private:
+    /// 常見的 cache line 大小
+    static constexpr size_t CACHE_LINE = 64;
+
+    /// single-producer / single-consumer ring buffer
+    struct Ring {
+        alignas(CACHE_LINE) std::atomic<size_t> m_head{ 0 };  ///< 下一個要讀的位置，只有 consumer 會寫
+        alignas(CACHE_LINE) std::atomic<size_t> m_tail{ 0 };  ///< 下一個要寫的位置，只有 producer 會寫
+        alignas(CACHE_LINE) std::vector<value_type> m_slots;
+
+        explicit Ring(size_t capacity) : m_slots(capacity) {}
+    };
+
+public:
+    /// producer 端的操作介面，每個 producer thread 各自持有一個
+    class Producer {
+        friend class IngestBuffer;
+
+        Ring* m_ring;
+        size_t m_mask;
+
+        Producer(Ring* ring) : m_ring(ring), m_mask(ring->m_slots.size() - 1) {}
+
+    public:
+        /// @brief 嘗試放入 value，ring buffer 滿了就放棄
+        /// @return `true`，成功；`false`，ring buffer 已滿
+        bool tryPush(const value_type& value) {
+            const size_t tail = m_ring->m_tail.load(std::memory_order_relaxed);
+            if (tail - m_ring->m_head.load(std::memory_order_acquire) > m_mask) return false;
+
+            m_ring->m_slots[tail & m_mask] = value;
+            m_ring->m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief 放入 value，ring buffer 滿了就讓出 CPU 等 consumer 取走
+        void push(const value_type& value) {
+            while (!tryPush(value)) std::this_thread::yield();
+        }
+    };
+
+private:
+    std::vector<std::unique_ptr<Ring>> m_rings;
+    std::atomic<size_t> m_producers{ 0 };
+    size_t m_capacity;
+
+    Heap m_heap;
+    /// drain() 用的暫存區，重複使用以避免配置記憶體
+    std::vector<value_type> m_batch;
+
+public:
+    /// @brief 建立 IngestBuffer
+    /// @param maxProducers - 最多有幾個 producer
+    /// @param capacity - 每個 producer 的 ring buffer 大小，會被調整成 2 的冪
+    /// @throw std::invalid_argument - 如果 maxProducers 或 capacity 為 0
+    IngestBuffer(size_t maxProducers, size_t capacity = 1024) : m_capacity(1) {
+        if (maxProducers == 0) throw std::invalid_argument("IngestBuffer - maxProducers must be positive");
+        if (capacity == 0)     throw std::invalid_argument("IngestBuffer - capacity must be positive");
+
+        while (m_capacity < capacity) m_capacity <<= 1;
+
+        m_rings.reserve(maxProducers);
+        for (size_t i = 0; i < maxProducers; ++i) m_rings.emplace_back(new Ring(m_capacity));
+        m_batch.reserve(m_capacity * maxProducers);
+    }
+
+    IngestBuffer(const IngestBuffer&) = delete;
+    IngestBuffer& operator=(const IngestBuffer&) = delete;
+
+    /// @brief 註冊新的 producer，可以在任何 thread 呼叫
+    /// @throw std::length_error - 如果 producer 的數量超過 maxProducers
+    Producer registerProducer() {
+        const size_t id = m_producers.fetch_add(1, std::memory_order_relaxed);
+        if (id >= m_rings.size()) throw std::length_error("IngestBuffer::registerProducer - too many producers");
+        return Producer(m_rings[id].get());
+    }
+
+    /// @brief 把所有 ring buffer 中的值批次插入 heap
+    /// @return 這次插入了幾個值
+    size_t drain() {
+        m_batch.clear();
+
+        const size_t n = std::min(m_producers.load(std::memory_order_relaxed), m_rings.size());
+        for (size_t i = 0; i < n; ++i) {
+            Ring& ring = *m_rings[i];
+            const size_t head = ring.m_head.load(std::memory_order_relaxed);
+            const size_t tail = ring.m_tail.load(std::memory_order_acquire);
+
+            for (size_t j = head; j != tail; ++j) m_batch.push_back(std::move(ring.m_slots[j & (m_capacity - 1)]));
+            ring.m_head.store(tail, std::memory_order_release);
+        }
+
+        m_heap.pushRange(m_batch.begin(), m_batch.end());
+        return m_batch.size();
+    }
+
+    /// @brief 移除最小值並回傳
+    /// @throw std::out_of_range - 如果沒有任何值
+    value_type popMin() { drain(); return m_heap.popMin(); }
+
+    /// @brief 移除最大值並回傳
+    /// @throw std::out_of_range - 如果沒有任何值
+    value_type popMax() { drain(); return m_heap.popMax(); }
+
+    /// @brief 回傳最小值，不移除
+    /// @throw std::out_of_range - 如果沒有任何值
+    const value_type& peekMin() { drain(); return m_heap.peekMin(); }
+
+    /// @brief 回傳最大值，不移除
+    /// @throw std::out_of_range - 如果沒有任何值
+    const value_type& peekMax() { drain(); return m_heap.peekMax(); }
+
+    /// 已經交給 consumer 的值有幾個（會先呼叫 drain）
+    size_t size() { drain(); return m_heap.size(); }
+};
+
+#endif // INGESTBUFFER_H
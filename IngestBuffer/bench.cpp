@@ -0,0 +1,127 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 IngestBuffer 和「用 mutex 保護的 MinMaxHeap」在 1 ~ 64 個 producer 下的吞吐量及 producer 每次 push 的延遲
+ */
+#include "IngestBuffer.h"
+#include "MinMaxHeap.h"
+#include "Benchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const size_t TOTAL = 1 << 21; ///< 所有 producer 總共 push 幾個值
+static const size_t SAMPLE = 8;      ///< 每個 producer 每隔幾次 push 量一次延遲，避免讀時鐘的成本蓋過 push 本身
+
+/// 排序後第 q 分位的值
+static double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * v.size()))];
+}
+
+/// 印出 push 延遲的分位數
+static void reportLatency(const std::vector<double>& latency) {
+    printf("    push (ns): p50 %10.0f p99 %10.0f max %10.0f\n",
+           percentile(latency, 0.5), percentile(latency, 0.99), percentile(latency, 1.0));
+}
+
+/**
+ * @brief 啟動 producers 個 thread，每個 thread 呼叫 push(producerId, value)；consumer 在目前的 thread 呼叫 pop() 直到收完
+ * @param latency - 存放所有 producer 每 SAMPLE 次 push 中一次的延遲（奈秒）
+ * @return 總共花費的秒數
+ */
+template<typename MakePush, typename Pop>
+static double run(size_t producers, MakePush makePush, Pop pop, std::vector<double>& latency)
+{
+    const size_t perProducer = TOTAL / producers;
+    std::atomic<bool> start{ false };
+    std::vector<std::vector<double>> sampled(producers);
+    std::vector<std::thread> threads;
+
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            auto push = makePush();
+            std::vector<double>& mine = sampled[p];
+            mine.reserve(perProducer / SAMPLE + 1);
+            while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+
+            for (size_t i = 0; i < perProducer; ++i) {
+                const int value = static_cast<int>(i * producers + p);
+                if (i % SAMPLE != 0) {
+                    push(value);
+                    continue;
+                }
+                const Clock::time_point begin = Clock::now();
+                push(value);
+                mine.push_back(std::chrono::duration<double, std::nano>(Clock::now() - begin).count());
+            }
+        });
+    }
+
+    Benchmark::Timer timer;
+    start.store(true, std::memory_order_release);
+
+    for (size_t received = 0; received < perProducer * producers; ) {
+        const size_t got = pop();
+        if (got == 0) std::this_thread::yield();
+        received += got;
+    }
+
+    const double total = timer.seconds();
+    for (auto& t : threads) t.join();
+
+    latency.clear();
+    for (const auto& v : sampled) latency.insert(latency.end(), v.begin(), v.end());
+    return total;
+}
+
+int main()
+{
+    for (size_t producers : {1, 2, 4, 8, 16, 32, 64}) {
+        const size_t n = TOTAL / producers * producers;
+        std::vector<double> latency;
+        printf("== %zu producers, %zu values ==\n", producers, n);
+
+        {
+            std::mutex mutex;
+            MinMaxHeap heap;
+            const double t = run(producers,
+                [&] {
+                    return [&](int v) { std::lock_guard<std::mutex> lock(mutex); heap.push(v); };
+                },
+                [&]() -> size_t {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    const size_t n = heap.size();
+                    for (size_t i = 0; i < n; ++i) Benchmark::keep(heap.popMin());
+                    return n;
+                },
+                latency);
+            Benchmark::report("mutex + MinMaxHeap throughput", n, t);
+            reportLatency(latency);
+        }
+        {
+            IngestBuffer<MinMaxHeap> buffer(producers);
+            const double t = run(producers,
+                [&] {
+                    auto producer = buffer.registerProducer();
+                    return [producer](int v) mutable { producer.push(v); };
+                },
+                [&]() -> size_t {
+                    const size_t n = buffer.size();
+                    for (size_t i = 0; i < n; ++i) Benchmark::keep(buffer.popMin());
+                    return n;
+                },
+                latency);
+            Benchmark::report("IngestBuffer<MinMaxHeap> throughput", n, t);
+            reportLatency(latency);
+        }
+    }
+
+    return 0;
+}
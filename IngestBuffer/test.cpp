@@ -0,0 +1,68 @@
+#include "IngestBuffer.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+
+TEST(IngestBuffer, invalidArgument) {
+    ASSERT_THROW(IngestBuffer<>(0), std::invalid_argument);
+    ASSERT_THROW(IngestBuffer<>(1, 0), std::invalid_argument);
+
+    IngestBuffer<> buffer(1);
+    buffer.registerProducer();
+    ASSERT_THROW(buffer.registerProducer(), std::length_error);
+}
+
+TEST(IngestBuffer, singleThread) {
+    IngestBuffer<Deap> buffer(2, 4);
+    auto p1 = buffer.registerProducer();
+    auto p2 = buffer.registerProducer();
+
+    // ring buffer 的大小為 4
+    for (int v : {5, 1, 9, 3}) ASSERT_TRUE(p1.tryPush(v));
+    ASSERT_FALSE(p1.tryPush(7));
+    p2.push(0);
+
+    ASSERT_TRUE(buffer.size() == 5);
+    ASSERT_TRUE(buffer.popMin() == 0);
+    ASSERT_TRUE(buffer.popMax() == 9);
+
+    // drain 之後 ring buffer 又有空間了，而且會繞回開頭
+    for (int v : {8, 2, 6, 4}) ASSERT_TRUE(p1.tryPush(v));
+    ASSERT_TRUE(buffer.peekMax() == 8);
+    ASSERT_TRUE(buffer.peekMin() == 1);
+    ASSERT_TRUE(buffer.size() == 7);
+
+    ASSERT_THROW(IngestBuffer<>(1).popMin(), std::out_of_range);
+}
+
+TEST(IngestBuffer, multiThread) {
+    const int producers = 8, perProducer = 20000;
+    IngestBuffer<> buffer(producers, 64);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&buffer, p] {
+            auto producer = buffer.registerProducer();
+            for (int i = 0; i < perProducer; ++i) producer.push(p * perProducer + i);
+        });
+    }
+
+    // consumer 一邊收一邊 pop，每個值都要剛好出現一次
+    std::vector<bool> seen(producers * perProducer, false);
+    for (int received = 0; received < producers * perProducer; ) {
+        if (buffer.size() == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const int v = (received & 1) ? buffer.popMin() : buffer.popMax();
+        ASSERT_FALSE(seen[v]);
+        seen[v] = true;
+        ++received;
+    }
+
+    for (auto& t : threads) t.join();
+    ASSERT_TRUE(buffer.size() == 0);
+}
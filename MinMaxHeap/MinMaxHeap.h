@@ -5,9 +5,16 @@
 #ifndef MINMAXHEAP_H
 #define MINMAXHEAP_H
 
+#include "Sortedness.h"
 #include <vector>
 #include <initializer_list>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
 #include <stdint.h>
+#include <stddef.h>
 #include <assert.h>
 #include <limits>
 
@@ -33,38 +40,41 @@ namespace MinMaxHeap_Trait {
  * min node「小於等於」子樹中的其他節點；max node 則是「大於等於」子樹中的其他節點。
  * 區分的方式是基於節點所在的層數。
  * root node 是 min node；下一層的兩個節點為 max node；再下一層的四個節點為 min node；如此交錯出現……
+ * @tparam T - 元素的型別，需要支援 `<`、`>`、`==`
+ * @tparam Storage - 存放元素的容器，介面和 std::vector 相同（index 存取、push_back、pop_back、insert 到尾端……），
+ *                   例如 std::vector（BasicMinMaxHeap）或固定容量的 StaticVector
  */
-class MinMaxHeap {
+template<typename T, typename Storage>
+class GenericMinMaxHeap {
 public:
-    typedef int value_type;
+    typedef T value_type;
 
 private:
-    std::vector<value_type> m_data;
+    Storage m_data;
 
 public:
     /// 建立空的 Min-Max Heap
-    MinMaxHeap() = default;
+    GenericMinMaxHeap() = default;
+
+    /// @brief 直接使用已經排成 Min-Max Heap 的 storage，不重新建立
+    /// @details 讓 Storage 為指向外部記憶體的 view 時（例如 HeapForest），可以在別人管理的記憶體上執行 Min-Max Heap 的操作
+    /// @param storage - 內容已經是 Min-Max Heap 的排列
+    static GenericMinMaxHeap adopt(Storage storage) {
+        GenericMinMaxHeap heap;
+        heap.m_data = std::move(storage);
+        return heap;
+    }
 
     /// @brief  從 [first, last) 建立Min-Max Heap
     /// @tparam InputIt - 滿足 input iterator
     /// @param first - 範圍的起點（包含）
     /// @param last - 範圍的終點（不包含）
     template<typename InputIt>
-    MinMaxHeap(InputIt first, InputIt last) : m_data(first, last) {
-        if (m_data.empty()) return;
-        
-        size_t i = MinMaxHeap_Trait::parent(m_data.size() - 1);
-
-        // i 從最後一項的父節點 到 第0項
-        while (i != std::numeric_limits<size_t>::max()) {
-            pushDown(i);
-            --i;
-        }
-    }
+    GenericMinMaxHeap(InputIt first, InputIt last) : m_data(first, last) { buildHeap(); }
 
     /// @brief 從初始化串列建立Min-Max Heap
     /// @param list - 初始化串列
-    MinMaxHeap(std::initializer_list<value_type> list) : MinMaxHeap(list.begin(), list.end()) {}
+    GenericMinMaxHeap(std::initializer_list<value_type> list) : GenericMinMaxHeap(list.begin(), list.end()) {}
 
     /// @brief 移除最小值並回傳
     /// @return 被移除的最小值
@@ -74,21 +84,514 @@ public:
     /// @return 被移除的最大值
     value_type popMax();
 
+    /// @brief 回傳最小值，不移除
+    /// @throw std::out_of_range - 如果Min-Max Heap為空
+    const value_type& peekMin() const;
+
+    /// @brief 回傳最大值，不移除
+    /// @throw std::out_of_range - 如果Min-Max Heap為空
+    const value_type& peekMax() const;
+
     /// @brief 將value插入Min-Max Heap
     /// @param value 插入的值
     void push(value_type value);
 
+    /// @brief 一次插入 [first, last) 內的所有值
+    /// @details 插入的數量夠多時，直接把整個 m_data 重建（O(n + k)），否則一個一個 push（O(k log n)）
+    /// @tparam ForwardIt - 滿足 forward iterator
+    /// @param first - 範圍的起點（包含）
+    /// @param last - 範圍的終點（不包含）
+    template<typename ForwardIt>
+    void pushRange(ForwardIt first, ForwardIt last) {
+        const size_t k = static_cast<size_t>(std::distance(first, last));
+
+        size_t logN = 1;
+        for (size_t n = m_data.size() + k; n > 1; n >>= 1) ++logN;
+
+        if (k * logN > m_data.size() + k) {
+            m_data.insert(m_data.end(), first, last);
+            buildHeap();
+        }
+        else {
+            for (; first != last; ++first) push(*first);
+        }
+    }
+
     /// 有幾個元素
     size_t size() const { return m_data.size(); }
 
+    /// @brief 依內部的排列順序（不是排序好的順序）走訪所有元素，可以搭配範圍建構子把內容搬到其他 heap
+    auto begin() const { return m_data.begin(); }
+    auto end() const { return m_data.end(); }
+
+    /// @brief 回傳第 k 小的值，不會修改 Min-Max Heap
+    /// @param k - 排名，從 1 開始（`kthSmallest(1)` 即為最小值）
+    /// @return 第 k 小的值
+    /// @throw std::out_of_range - 如果 k 為 0 或大於 size()
+    /// @note 只會走訪 heap 上層的節點，時間複雜度為 O(k log k)
+    value_type kthSmallest(size_t k) const;
+
+    /// @brief 回傳第 k 大的值，不會修改 Min-Max Heap
+    /// @param k - 排名，從 1 開始（`kthLargest(1)` 即為最大值）
+    /// @return 第 k 大的值
+    /// @throw std::out_of_range - 如果 k 為 0 或大於 size()
+    /// @note 只會走訪 heap 上層的節點，時間複雜度為 O(k log k)
+    value_type kthLargest(size_t k) const;
+
+    /// @brief 將所有元素排序後移到 out，呼叫後 Min-Max Heap 為空
+    /// @details 直接在 m_data 內做 heap sort，不需要額外配置記憶體
+    /// @param out - 存放結果，原本的內容會被丟棄
+    /// @param ascending - `true`，由小到大；`false`，由大到小
+    void drainSorted(std::vector<value_type>& out, bool ascending = true);
+
 private:
     /// 確認節點存在
-    bool exist(size_t id) { return id < m_data.size(); }
+    bool exist(size_t id) const { return id < m_data.size(); }
+
+    /// @brief 將 m_data 的內容轉成 Min-Max Heap
+    /// @details 已經排序（遞增或遞減）的輸入直接用 layoutSorted 擺放；只有少數幾個遞增 run 的輸入先合併再擺放；其他的做 heapify
+    void buildHeap() {
+        using namespace Sortedness_Trait;
+        if (m_data.size() < 2) return;
+
+        const Sortedness s = sortedness(m_data);
+        if (s.descents == 0) { layoutSorted(true);  return; }
+        if (!s.hasAscent)    { layoutSorted(false); return; }
+        if (s.descents < MAX_RUNS) {
+            mergeRuns(m_data, s);
+            layoutSorted(true);
+            return;
+        }
+
+        size_t i = MinMaxHeap_Trait::parent(m_data.size() - 1);
+
+        // i 從最後一項的父節點 到 第0項
+        while (i != std::numeric_limits<size_t>::max()) {
+            pushDown(i);
+            --i;
+        }
+    }
+
+    /// @brief 把已經排序的 m_data 原地擺成 Min-Max Heap，不需要比較
+    /// @param ascending - m_data 是遞增還是遞減
+    void layoutSorted(bool ascending);
 
     /// @brief 使以 root 為根的子樹滿足 Min-Max Heap 的特性（min node「小於等於」子樹的其他節點，max node「大於等於」子樹的其他節點）
     /// @param root - 子樹的根
     /// @pre root 的左右子樹都滿足 Min-Max Heap 的特性
-    void pushDown(size_t root);
+    void pushDown(size_t root) { pushDown(root, m_data.size()); }
+
+    /// @brief 同 pushDown(size_t)，但只把 [0, end) 內的節點當作 heap
+    /// @param root - 子樹的根
+    /// @param end - heap 的範圍（不包含）
+    void pushDown(size_t root, size_t end);
+
+    /// @brief 移除 hole 上的值後，用 value 補回 [0, end) 的 heap（bottom-up deletion）
+    /// @param hole - 被移除的節點，0（min node）或 1、2（max node）
+    /// @param end - heap 的範圍（不包含）
+    /// @param value - 要放回 heap 的值，通常是原本在 end 的值
+    void fillHole(size_t hole, size_t end, value_type value);
+
+    /// @brief 使 id 上的值和到 root 路徑上的節點滿足 Min-Max Heap 的特性
+    /// @param id - 節點，必須是 leaf
+    /// @param minLevel - id 是不是 min node，由呼叫端提供，避免用 isMinNode 重新計算
+    void siftUp(size_t id, bool minLevel);
+
+    /// @brief kthSmallest 和 kthLargest 的實作
+    /// @param k - 排名，從 1 開始
+    /// @param smallest - `true`，找第 k 小；`false`，找第 k 大
+    value_type kthElement(size_t k, bool smallest) const;
 };
 
-#endif // MINMAXHEAP_H
\ No newline at end of file
+/// 用 std::vector 存放元素的 Min-Max Heap
+template<typename T>
+using BasicMinMaxHeap = GenericMinMaxHeap<T, std::vector<T>>;
+
+/// 存放 int 的 Min-Max Heap
+typedef BasicMinMaxHeap<int> MinMaxHeap;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+template<typename T, typename Storage>
+typename GenericMinMaxHeap<T, Storage>::value_type GenericMinMaxHeap<T, Storage>::popMin()
+{
+    if (size() == 0) throw std::out_of_range("MinMaxHeap::popMin - no element");
+
+    value_type ret = std::move(m_data.front());
+
+    value_type last = std::move(m_data.back());
+    m_data.pop_back();
+    if (!m_data.empty()) fillHole(0, size(), std::move(last));
+
+    return ret;
+}
+
+template<typename T, typename Storage>
+typename GenericMinMaxHeap<T, Storage>::value_type GenericMinMaxHeap<T, Storage>::popMax()
+{
+    switch (size())
+    {
+    case 0:
+        throw std::out_of_range("MinMaxHeap::popMax - no element");
+
+    case 1: case 2: {
+        value_type ret = std::move(m_data.back());
+        m_data.pop_back();
+        return ret;
+    }
+
+    default: {
+        size_t max_node = m_data[1] > m_data[2] ? 1 : 2;
+        value_type ret = std::move(m_data[max_node]);
+
+        value_type last = std::move(m_data.back());
+        m_data.pop_back();
+        // 最大值剛好是最後一個節點時，直接移除就好
+        if (max_node < size()) fillHole(max_node, size(), std::move(last));
+
+        return ret;
+    }
+    }
+}
+
+template<typename T, typename Storage>
+const typename GenericMinMaxHeap<T, Storage>::value_type& GenericMinMaxHeap<T, Storage>::peekMin() const
+{
+    if (size() == 0) throw std::out_of_range("MinMaxHeap::peekMin - no element");
+    return m_data.front();
+}
+
+template<typename T, typename Storage>
+const typename GenericMinMaxHeap<T, Storage>::value_type& GenericMinMaxHeap<T, Storage>::peekMax() const
+{
+    switch (size())
+    {
+    case 0:
+        throw std::out_of_range("MinMaxHeap::peekMax - no element");
+
+    case 1: case 2:
+        return m_data.back();
+
+    default:
+        return m_data[1] > m_data[2] ? m_data[1] : m_data[2];
+    }
+}
+
+template<typename T, typename Storage>
+void GenericMinMaxHeap<T, Storage>::push(value_type value)
+{
+    m_data.push_back(std::move(value));
+
+    const size_t id = size() - 1;
+    siftUp(id, MinMaxHeap_Trait::isMinNode(id));
+}
+
+template<typename T, typename Storage>
+typename GenericMinMaxHeap<T, Storage>::value_type GenericMinMaxHeap<T, Storage>::kthSmallest(size_t k) const
+{
+    if (k == 0 || k > size()) throw std::out_of_range("MinMaxHeap::kthSmallest - k out of range");
+    return kthElement(k, true);
+}
+
+template<typename T, typename Storage>
+typename GenericMinMaxHeap<T, Storage>::value_type GenericMinMaxHeap<T, Storage>::kthLargest(size_t k) const
+{
+    if (k == 0 || k > size()) throw std::out_of_range("MinMaxHeap::kthLargest - k out of range");
+    return kthElement(k, false);
+}
+
+template<typename T, typename Storage>
+void GenericMinMaxHeap<T, Storage>::drainSorted(std::vector<value_type>& out, bool ascending)
+{
+    // 每一輪把最大值（由小到大）或最小值（由大到小）換到 [0, end) 的最後一格，
+    // 已排好的部分從 m_data 的尾端往前長，所以不需要額外的空間
+    for (size_t end = m_data.size(); end > 1; --end) {
+        const size_t last = end - 1;
+
+        size_t top;
+        if (!ascending)    top = 0;
+        else if (end == 2) top = 1;
+        else               top = m_data[1] > m_data[2] ? 1 : 2;
+
+        if (top == last) continue;
+
+        value_type removed = std::move(m_data[top]);
+        fillHole(top, last, std::move(m_data[last]));
+        m_data[last] = std::move(removed);
+    }
+
+    if constexpr (std::is_same<Storage, std::vector<value_type>>::value) {
+        out = std::move(m_data);
+    }
+    else {
+        out.assign(std::make_move_iterator(m_data.begin()), std::make_move_iterator(m_data.end()));
+    }
+    m_data.clear();
+}
+
+/**
+ * @details
+ * # 演算法
+ * 以找第 k 小為例，用一個 frontier（以值排序的 heap）做 best-first search，每次取出 frontier 中最小的節點，第 k 次取出的就是答案。
+ * 
+ * 取出 min node 時，要把它的子節點和孫子節點加入 frontier：
+ * - 孫子節點是 min node，它「小於等於」自己的子樹，所以它的子樹要等它被取出後再展開。
+ * - 子節點是 max node，它「大於等於」自己的子樹，不過它的子節點就是上面的孫子節點，所以 max node 不需要展開。
+ *   雖然它可能比子樹中的值更早被加入 frontier，但 frontier 依值排序，所以它不會比子樹中更小的值先被取出。
+ * 
+ * 找第 k 大時完全對稱：max node 要展開，min node 不用展開。root 是 min node，所以一開始要把 root、節點 1 和節點 2 都加入 frontier。
+ * 
+ * 每取出一個節點最多加入 6 個節點，所以 frontier 的大小為 O(k)，總共花 O(k log k)。
+ */
+template<typename T, typename Storage>
+typename GenericMinMaxHeap<T, Storage>::value_type GenericMinMaxHeap<T, Storage>::kthElement(size_t k, bool smallest) const
+{
+    using namespace MinMaxHeap_Trait;
+
+    std::function<bool(const value_type&, const value_type&)> _less;
+    if (smallest) _less = std::less<value_type>();
+    else          _less = std::greater<value_type>();
+
+    struct Entry {
+        size_t id;
+        bool expand;   ///< 取出時是否要展開子節點和孫子節點
+    };
+
+    // std::push_heap 會把「最大」的放在最前面，所以比較時要反過來
+    auto later = [&](const Entry& a, const Entry& b) { return _less(m_data[b.id], m_data[a.id]); };
+
+    std::vector<Entry> frontier;
+    frontier.reserve(6 * k + 3);
+
+    auto add = [&](size_t id, bool expand) {
+        if (!exist(id)) return;
+        frontier.push_back({ id, expand });
+        std::push_heap(frontier.begin(), frontier.end(), later);
+    };
+
+    if (smallest) {
+        add(0, true);
+    }
+    else {
+        add(0, false);
+        add(1, true);
+        add(2, true);
+    }
+
+    while (true) {
+        std::pop_heap(frontier.begin(), frontier.end(), later);
+        const Entry e = frontier.back();
+        frontier.pop_back();
+
+        if (--k == 0) return m_data[e.id];
+
+        if (e.expand) {
+            const size_t L = leftChild(e.id), R = rightChild(e.id);
+            add(L, false);
+            add(R, false);
+            add(leftChild(L), true);
+            add(rightChild(L), true);
+            add(leftChild(R), true);
+            add(rightChild(R), true);
+        }
+    }
+}
+
+/**
+ * @details
+ * # 演算法
+ * 原本的做法是把最後一個值放到 hole，再 pushDown：每往下兩層要比較 6 個子孫，還要和父節點比一次，
+ * 而最後一個值通常很「大」，幾乎都會沉到底。
+ *
+ * 這裡改成先不管 value，只沿著 hole 子樹中最「小」的子孫往下走，把它往上搬一層補洞（以 hole 是 min node 為例）：
+ * - 子節點是 max node，它「大於等於」自己的子樹，所以子樹中最「小」的值只可能在孫子，或沒有子節點的子節點
+ * - 四個孫子都存在時只需要比較 3 次，而且完全不用和 value 比較
+ *
+ * 走到 leaf 後把 value 放進去，再用和 push 一樣的 siftUp 往上調整。value 通常很「大」，所以 siftUp 很快就停了。
+ *
+ * 往下走時 hole 一直在同一種層（每次走兩層），只有最後補到子節點時才換成另一種，所以不需要呼叫 isMinNode。
+ */
+template<typename T, typename Storage>
+void GenericMinMaxHeap<T, Storage>::fillHole(size_t hole, size_t end, value_type value)
+{
+    using namespace MinMaxHeap_Trait;
+
+    bool minLevel = hole == 0;
+    auto better = [minLevel](const value_type& a, const value_type& b) { return minLevel ? a < b : a > b; };
+
+    while (true) {
+        const size_t L = leftChild(hole), R = rightChild(hole);
+        if (L >= end) break;
+
+        // 候選的節點：有子節點的子節點換成它的子節點（孫子），沒有的話就是它自己
+        size_t candidates[4];
+        size_t n = 0;
+        const size_t grandchild = leftChild(L);
+        if (grandchild < end) {
+            candidates[n++] = grandchild;
+            if (grandchild + 1 < end) candidates[n++] = grandchild + 1;
+        }
+        else candidates[n++] = L;
+
+        if (R < end) {
+            if (grandchild + 2 < end) {
+                candidates[n++] = grandchild + 2;
+                if (grandchild + 3 < end) candidates[n++] = grandchild + 3;
+            }
+            else candidates[n++] = R;
+        }
+
+        size_t M = candidates[0];
+        for (size_t i = 1; i < n; ++i) {
+            if (better(m_data[candidates[i]], m_data[M])) M = candidates[i];
+        }
+
+        m_data[hole] = std::move(m_data[M]);
+        hole = M;
+
+        // 補到子節點時，hole 變成另一種層的 leaf
+        if (M <= R) {
+            minLevel = !minLevel;
+            break;
+        }
+    }
+
+    m_data[hole] = std::move(value);
+    siftUp(hole, minLevel);
+}
+
+template<typename T, typename Storage>
+void GenericMinMaxHeap<T, Storage>::siftUp(size_t id, bool minLevel)
+{
+    using namespace MinMaxHeap_Trait;
+
+    const size_t parentId = parent(id);
+
+    // 只有一個節點 或 和父節點的值一樣
+    // 不論父節點是min或max node，放一樣的值在底下都不會違反父節點的性質
+    // 對於更上層的節點，因為沒有更大或更小的值出現，所以一樣不會違反性質
+    if (m_data[id] == m_data[parentId])
+        return;
+    
+    value_type value = std::move(m_data[id]);
+
+    // 新節點 < 到root的路徑上所有的max node
+    // 目標：將新節點插入路徑上的min node序列內，使min node由上至下遞增
+    if (value < m_data[parentId]) {
+        // 比id上層的min node
+        size_t prevMin = minLevel ? parent(parentId) : parentId;
+
+        while (id != 0) {
+            if (value < m_data[prevMin]) {
+                m_data[id] = std::move(m_data[prevMin]);
+                id = prevMin;
+                prevMin = parent(parent(prevMin));
+            }
+            else
+                break;
+        }
+        
+        m_data[id] = std::move(value);
+    }
+    // 新節點 > 到root的路徑上所有的min node
+    // 目標：將新節點插入路徑上的max node序列內，使max node由上至下遞減
+    else {
+        // 比id上層的max node
+        size_t prevMax = minLevel ? parentId : parent(parentId);
+
+        while (id != 1 && id != 2) {
+            if (value > m_data[prevMax]) {
+                m_data[id] = std::move(m_data[prevMax]);
+                id = prevMax;
+                prevMax = parent(parent(prevMax));
+            }
+            else
+                break;
+        }
+
+        m_data[id] = std::move(value);
+    }
+}
+
+/**
+ * @details
+ * # 演算法
+ * 依 index 的順序擺放：min node 依序拿剩下最小的值，max node 依序拿剩下最大的值。
+ * - 所有 min node 的值都小於等於所有 max node 的值，所以 min node 和 max node 之間不會違反特性
+ * - 同一種節點中，越上層的 index 越小、越早拿，所以 min node 由上往下遞增，max node 由上往下遞減
+ *
+ * 第 i 個節點拿的是排序後的第幾個值，可以從它前面有幾個 min node 直接算出來，
+ * 所以用 Sortedness_Trait::permute 原地搬移，不需要第二份 m_data。
+ */
+template<typename T, typename Storage>
+void GenericMinMaxHeap<T, Storage>::layoutSorted(bool ascending)
+{
+    const size_t n = m_data.size();
+
+    Sortedness_Trait::permute(m_data, [n, ascending](size_t i) {
+        const size_t level = Sortedness_Trait::floorLog2(i + 1);
+        const bool minLevel = level % 2 == 0;
+
+        // 上面每一個 min level 的節點數：1 + 4 + 16 + ...
+        const size_t minLevelsAbove = (level + 1) / 2;
+        size_t minBefore = ((size_t(1) << (2 * minLevelsAbove)) - 1) / 3;
+        if (minLevel) minBefore += i + 1 - (size_t(1) << level);
+
+        // 遞增時最小的值在前面，遞減時在後面
+        const size_t taken = minLevel ? minBefore : i - minBefore;
+        return minLevel == ascending ? taken : n - 1 - taken;
+    });
+}
+
+template<typename T, typename Storage>
+void GenericMinMaxHeap<T, Storage>::pushDown(size_t root, size_t end)
+{
+    using namespace MinMaxHeap_Trait;
+
+    // min node 和 max node 的處理方式是對稱的，只不過一個是用「小於」、一個是用「大於」
+    std::function<bool(const value_type&, const value_type&)> _less;
+
+    if (isMinNode(root)) _less = std::less<value_type>();
+    else                 _less = std::greater<value_type>();
+
+    // 在下面的註解中，我假設 root 是「min node」，而 _less 是「小於」
+    // root 是「max node」的情形，請自行將「」內的字替換成反義詞
+    while (root < end) {
+        // root 的兩個子節點及四個孫子
+        const size_t children[] = {
+            leftChild(root),                                 rightChild(root),
+            leftChild(children[0]), rightChild(children[0]), leftChild(children[1]), rightChild(children[1])
+        };
+
+        // 找子樹中最「小」的節點
+        // 搜尋時只要找兩層，因為再往下不會有更「小」的（Note: 孫子那層是「min node」，所以孫子「<=」更下層的節點）
+        size_t M = root;
+        for (auto id : children) {
+            if (id < end && _less(m_data[id],  m_data[M]))
+                M = id;
+        }
+
+        // 已經滿足特性
+        if (M == root)
+            return;
+        else {
+            // root變最「小」的值，而M變「大」
+            std::swap(m_data[root], m_data[M]);
+
+            size_t parentM = parent(M);
+            
+            // 若M是「max node」，他的值變「大」不會影響子樹的性質
+            if (parentM == root) return;
+            
+            // 否則，M是「min node」，值不能變得比parent「大」
+            if (_less(m_data[parentM], m_data[M]))
+                std::swap(m_data[parentM], m_data[M]);
+
+            // M的值可能變得比子樹「大」，所以繼續pushDown
+            root = M;
+        }
+    }
+}
+
+#endif // MINMAXHEAP_H
@@ -0,0 +1,174 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 popMin、popMax 改成 bottom-up deletion 前後的比較次數和速度，以及 MinMaxHeap、Deap 的建構在不同輸入順序下的表現
+ */
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Benchmark::Counted;
+
+/// 改版前的 popMin、popMax：把最後一個值放到 root（或最大的 max node），再 pushDown
+template<typename T>
+class TopDownHeap {
+    std::vector<T> m_data;
+
+public:
+    typedef T value_type;
+
+    template<typename InputIt>
+    TopDownHeap(InputIt first, InputIt last) : m_data(first, last) {
+        for (size_t i = m_data.size() / 2; i-- > 0; ) pushDown(i);
+    }
+
+    size_t size() const { return m_data.size(); }
+
+    T popMin() {
+        T ret = std::move(m_data.front());
+        m_data.front() = std::move(m_data.back());
+        m_data.pop_back();
+        pushDown(0);
+        return ret;
+    }
+
+    T popMax() {
+        if (m_data.size() <= 2) {
+            T ret = std::move(m_data.back());
+            m_data.pop_back();
+            return ret;
+        }
+        const size_t maxNode = m_data[1] > m_data[2] ? 1 : 2;
+        T ret = std::move(m_data[maxNode]);
+        m_data[maxNode] = std::move(m_data.back());
+        m_data.pop_back();
+        pushDown(maxNode);
+        return ret;
+    }
+
+private:
+    void pushDown(size_t root) {
+        using namespace MinMaxHeap_Trait;
+        const size_t end = m_data.size();
+
+        std::function<bool(const T&, const T&)> _less;
+        if (isMinNode(root)) _less = std::less<T>();
+        else                 _less = std::greater<T>();
+
+        while (root < end) {
+            const size_t children[] = {
+                leftChild(root),                                 rightChild(root),
+                leftChild(children[0]), rightChild(children[0]), leftChild(children[1]), rightChild(children[1])
+            };
+
+            size_t M = root;
+            for (auto id : children) {
+                if (id < end && _less(m_data[id], m_data[M])) M = id;
+            }
+            if (M == root) return;
+
+            std::swap(m_data[root], m_data[M]);
+            const size_t parentM = parent(M);
+            if (parentM == root) return;
+            if (_less(m_data[parentM], m_data[M])) std::swap(m_data[parentM], m_data[M]);
+            root = M;
+        }
+    }
+};
+
+/// @brief 建好 heap 後 pop 到清空
+/// @param pattern：0 只 popMin，1 只 popMax，2 交錯
+template<typename Heap>
+static void bench(const std::string& name, const std::vector<Counted>& data, int pattern)
+{
+    static const char* patterns[] = { "popMin", "popMax", "alternate" };
+
+    Heap heap(data.begin(), data.end());
+    Counted::comparisons = 0;
+
+    const double t = Benchmark::measure([&] {
+        for (size_t i = 0; i < data.size(); ++i) {
+            const bool min = pattern == 0 || (pattern == 2 && (i & 1));
+            Benchmark::keep((min ? heap.popMin() : heap.popMax()).value);
+        }
+    });
+
+    Benchmark::report((name + " " + patterns[pattern]).c_str(), data.size(), t);
+    printf("%-52s %12.2f cmp/op\n", "", double(Counted::comparisons) / data.size());
+}
+
+/// @brief 用 [first, last) 建構 Heap，印出時間和比較次數
+template<typename Heap>
+static void benchBuild(const std::string& name, const std::vector<Counted>& data)
+{
+    const int repeat = 5;
+    Counted::comparisons = 0;
+
+    const double t = Benchmark::measure([&] {
+        for (int r = 0; r < repeat; ++r) {
+            Heap heap(data.begin(), data.end());
+            Benchmark::keep(heap.size());
+        }
+    });
+
+    Benchmark::report(name.c_str(), data.size() * repeat, t);
+    printf("%-52s %12.2f cmp/op\n", "", double(Counted::comparisons) / (data.size() * repeat));
+}
+
+static void popSection(std::mt19937& gen)
+{
+    for (size_t n : {size_t(1) << 10, size_t(1) << 16, size_t(1) << 20}) {
+        std::uniform_int_distribution<int> dist;
+        std::vector<Counted> data(n);
+        for (Counted& c : data) c.value = dist(gen);
+
+        printf("== pop, n = %zu ==\n", n);
+        for (int pattern = 0; pattern < 3; ++pattern) {
+            bench<TopDownHeap<Counted>>("top-down (old)", data, pattern);
+            bench<BasicMinMaxHeap<Counted>>("bottom-up", data, pattern);
+        }
+    }
+}
+
+static void buildSection(std::mt19937& gen)
+{
+    const size_t n = size_t(1) << 20;
+    std::vector<std::pair<std::string, std::vector<Counted>>> inputs;
+
+    std::vector<Counted> data(n);
+    for (size_t i = 0; i < n; ++i) data[i].value = int(i);
+    inputs.emplace_back("sorted", data);
+
+    std::reverse(data.begin(), data.end());
+    inputs.emplace_back("reversed", data);
+
+    // 兩段遞增：例如排序好的 checkpoint 後面接一段新的資料
+    for (size_t i = 0; i < n; ++i) data[i].value = int(i < n / 2 ? i * 2 : (i - n / 2) * 2 + 1);
+    inputs.emplace_back("two runs", data);
+
+    for (size_t i = 0; i < n; ++i) data[i].value = int(i % 1024);
+    inputs.emplace_back("sawtooth (1024)", data);
+    for (size_t i = 0; i < n; ++i) data[i].value = int(gen());
+    inputs.emplace_back("random", data);
+
+    printf("== build, n = %zu ==\n", n);
+    for (auto& input : inputs) {
+        benchBuild<BasicMinMaxHeap<Counted>>("MinMaxHeap " + input.first, input.second);
+        benchBuild<BasicDeap<Counted>>("Deap " + input.first, input.second);
+    }
+}
+
+int main()
+{
+    std::mt19937 gen(12345);
+
+    popSection(gen);
+    buildSection(gen);
+
+    return 0;
+}
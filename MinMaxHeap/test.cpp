@@ -1,5 +1,7 @@
 #include "MinMaxHeap.h"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
 
 TEST(MinMaxHeap, ParentTest) {
     ASSERT_TRUE(MinMaxHeap_Trait::parent(0) == 0);
@@ -103,3 +105,158 @@ TEST(MinMaxHeap, pushTest) {
     }
 }
 
+
+TEST(MinMaxHeap, kthTest) {
+    std::vector<int> vec;
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed;
+    srand(seed);
+
+    for (int i = 0; i < 100; ++i) vec.push_back(rand() % 10);
+
+    const MinMaxHeap mmheap(vec.begin(), vec.end());
+    std::sort(vec.begin(), vec.end());
+
+    for (size_t k = 1; k <= vec.size(); ++k) {
+        ASSERT_TRUE(mmheap.kthSmallest(k) == vec[k - 1]);
+        ASSERT_TRUE(mmheap.kthLargest(k) == vec[vec.size() - k]);
+    }
+    ASSERT_TRUE(mmheap.size() == 100);
+
+    ASSERT_THROW(mmheap.kthSmallest(0), std::out_of_range);
+    ASSERT_THROW(mmheap.kthLargest(101), std::out_of_range);
+}
+
+TEST(MinMaxHeap, drainSortedTest) {
+    std::vector<int> vec, sorted, out;
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed;
+    srand(seed);
+
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(rand() % 10);
+        sorted = vec;
+        std::sort(sorted.begin(), sorted.end());
+
+        MinMaxHeap asc(vec.begin(), vec.end());
+        asc.drainSorted(out);
+        ASSERT_TRUE(asc.size() == 0);
+        ASSERT_TRUE(out == sorted);
+
+        MinMaxHeap desc(vec.begin(), vec.end());
+        desc.drainSorted(out, false);
+        ASSERT_TRUE(desc.size() == 0);
+        ASSERT_TRUE(std::equal(out.rbegin(), out.rend(), sorted.begin(), sorted.end()));
+    }
+}
+
+TEST(MinMaxHeap, peekTest) {
+    MinMaxHeap mmheap;
+    ASSERT_THROW(mmheap.peekMin(), std::out_of_range);
+    ASSERT_THROW(mmheap.peekMax(), std::out_of_range);
+
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed;
+    srand(seed);
+    for (int i = 0; i < 100; ++i)
+        mmheap.push(rand() % 10);
+
+    while (mmheap.size()) {
+        const int minV = mmheap.peekMin(), maxV = mmheap.peekMax();
+        if (rand() & 1) ASSERT_TRUE(mmheap.popMin() == minV);
+        else            ASSERT_TRUE(mmheap.popMax() == maxV);
+    }
+}
+
+TEST(MinMaxHeap, templateTest) {
+    BasicMinMaxHeap<std::string> mmheap {"d", "a", "c", "e", "b"};
+    mmheap.push("f");
+
+    ASSERT_TRUE(mmheap.popMin() == "a");
+    ASSERT_TRUE(mmheap.popMax() == "f");
+    ASSERT_TRUE(mmheap.popMax() == "e");
+    ASSERT_TRUE(mmheap.popMin() == "b");
+    ASSERT_TRUE(mmheap.size() == 2);
+}
+
+TEST(MinMaxHeap, pushRangeTest) {
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed;
+    srand(seed);
+
+    // 小批次會一個一個 push，大批次會重建
+    for (size_t batch : {1, 5, 100, 1000}) {
+        MinMaxHeap mmheap;
+        std::vector<int> all, vec;
+
+        for (int round = 0; round < 5; ++round) {
+            vec.clear();
+            for (size_t i = 0; i < batch; ++i) vec.push_back(rand() % 10);
+            mmheap.pushRange(vec.begin(), vec.end());
+            all.insert(all.end(), vec.begin(), vec.end());
+        }
+
+        std::vector<int> out;
+        mmheap.drainSorted(out);
+        std::sort(all.begin(), all.end());
+        ASSERT_TRUE(out == all);
+    }
+}
+
+TEST(MinMaxHeap, mixedOperationTest) {
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed;
+    srand(seed);
+
+    // popMin、popMax 會把最後一個值補到 leaf 再往上調整，各種大小、重複值和 push 交錯都要正確
+    MinMaxHeap mmheap;
+    std::vector<int> model;
+    for (int i = 0; i < 20000; ++i) {
+        const int op = rand() % 5;
+        if (op < 2 || model.empty()) {
+            const int v = rand() % 100;
+            mmheap.push(v);
+            model.push_back(v);
+        }
+        else if (op == 2) {
+            auto it = std::min_element(model.begin(), model.end());
+            ASSERT_TRUE(mmheap.popMin() == *it);
+            model.erase(it);
+        }
+        else {
+            auto it = std::max_element(model.begin(), model.end());
+            ASSERT_TRUE(mmheap.popMax() == *it);
+            model.erase(it);
+        }
+        ASSERT_TRUE(mmheap.size() == model.size());
+    }
+}
+
+TEST(MinMaxHeap, sortedInputTest) {
+    // 遞增、遞減、全部一樣、少數幾個 run、很多 run（走 heapify）
+    auto shapes = [](size_t n) {
+        std::vector<std::vector<int>> res(6);
+        for (size_t i = 0; i < n; ++i) {
+            res[0].push_back(int(i));
+            res[1].push_back(int(n - i));
+            res[2].push_back(7);
+            res[3].push_back(int(i % (n / 2 + 1)));
+            res[4].push_back(int(i % (n / 3 + 1)));
+            res[5].push_back(int(i % 5));
+        }
+        return res;
+    };
+
+    for (size_t n = 0; n < 100; ++n) {
+        for (auto& vec : shapes(n)) {
+            std::vector<int> sorted = vec;
+            std::sort(sorted.begin(), sorted.end());
+
+            MinMaxHeap mmheap(vec.begin(), vec.end());
+            for (size_t lo = 0, hi = n; lo < hi; ) {
+                if ((lo + hi) & 1) ASSERT_TRUE(mmheap.popMin() == sorted[lo++]);
+                else               ASSERT_TRUE(mmheap.popMax() == sorted[--hi]);
+            }
+        }
+    }
+}
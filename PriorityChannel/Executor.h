@@ -0,0 +1,131 @@
+/**
+ * @file Executor.h
+ * @brief 測試 PriorityChannel 用的簡單 coroutine 工具：立即開始的 Task，以及單執行緒、多執行緒的 executor
+ * @note 需要 C++20
+ */
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+
+/// @brief 立即開始執行、沒有回傳值的 coroutine。結束時自己釋放 coroutine frame，所以不需要也不能被 co_await
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/**
+ * @brief 單執行緒的 executor
+ * @details `co_await executor.schedule()` 會把目前的 coroutine 排進佇列，等呼叫 run() 的 thread 來執行
+ */
+class SingleThreadExecutor {
+    std::deque<std::coroutine_handle<>> m_queue;
+
+public:
+    /// schedule() 回傳的 awaitable
+    struct Schedule {
+        SingleThreadExecutor* m_executor;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { m_executor->m_queue.push_back(h); }
+        void await_resume() const noexcept {}
+    };
+
+    /// 把目前的 coroutine 交給這個 executor
+    Schedule schedule() { return Schedule{ this }; }
+
+    /// @brief 執行佇列中的 coroutine，直到佇列為空
+    /// @return 執行了幾次
+    size_t run() {
+        size_t count = 0;
+        while (!m_queue.empty()) {
+            std::coroutine_handle<> h = m_queue.front();
+            m_queue.pop_front();
+            h.resume();
+            ++count;
+        }
+        return count;
+    }
+};
+
+/**
+ * @brief 固定數量 thread 的 executor
+ * @details `co_await executor.schedule()` 會把目前的 coroutine 交給其中一個 worker thread 繼續執行。解構時會等所有工作做完
+ */
+class ThreadPoolExecutor {
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::coroutine_handle<>> m_queue;
+    bool m_stop = false;
+    std::vector<std::thread> m_workers;
+
+public:
+    /// schedule() 回傳的 awaitable
+    struct Schedule {
+        ThreadPoolExecutor* m_executor;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { m_executor->post(h); }
+        void await_resume() const noexcept {}
+    };
+
+    /// @brief 建立 executor
+    /// @param threads - worker thread 的數量
+    explicit ThreadPoolExecutor(size_t threads) {
+        for (size_t i = 0; i < threads; ++i) m_workers.emplace_back([this] { work(); });
+    }
+
+    ~ThreadPoolExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& t : m_workers) t.join();
+    }
+
+    ThreadPoolExecutor(const ThreadPoolExecutor&) = delete;
+    ThreadPoolExecutor& operator=(const ThreadPoolExecutor&) = delete;
+
+    /// 把目前的 coroutine 交給這個 executor
+    Schedule schedule() { return Schedule{ this }; }
+
+    /// 把 coroutine 排進佇列
+    void post(std::coroutine_handle<> h) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(h);
+        }
+        m_cv.notify_one();
+    }
+
+private:
+    void work() {
+        while (true) {
+            std::coroutine_handle<> h;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+                if (m_queue.empty()) return;
+
+                h = m_queue.front();
+                m_queue.pop_front();
+            }
+            h.resume();
+        }
+    }
+};
+
+#endif // EXECUTOR_H
@@ -0,0 +1,200 @@
+/**
+ * @file PriorityChannel.h
+ * @brief 可以用 `co_await` 等待最小值或最大值的 priority channel
+ * @note 需要 C++20
+ */
+#ifndef PRIORITYCHANNEL_H
+#define PRIORITYCHANNEL_H
+
+#include "MinMaxHeap.h"
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <stddef.h>
+
+/**
+ * @brief 以 double-ended priority queue 為基礎的 channel
+ * @tparam Heap - 存放值的 heap，需要提供 push、popMin、popMax、size，例如 MinMaxHeap 或 Deap
+ * @details
+ * consumer 用 `co_await channel.popMin()` 或 `co_await channel.popMax()` 取值，回傳 `std::optional<value_type>`：
+ * - channel 中有值時，不會暫停，直接取出最小（或最大）的值
+ * - channel 為空時，consumer 會暫停並排進等待佇列（先來先得），不會佔用 CPU
+ * - channel 被 close() 而且已經沒有值時，回傳 `std::nullopt`
+ *
+ * push 時如果有 consumer 在等，值會直接交給最早開始等的 consumer，並在呼叫 push 的 thread 上立刻 resume 它，不需要經過其他 thread。
+ *
+ * 取消：如果暫停中的 coroutine 被 destroy，它的等待會自動從佇列中移除。
+ * 但 destroy 不能和其他 thread 上的 push 或 close 同時發生。
+ */
+template<typename Heap = MinMaxHeap>
+class PriorityChannel {
+public:
+    typedef typename Heap::value_type value_type;
+
+    /// popMin()、popMax() 回傳的 awaitable
+    class PopAwaiter {
+        friend class PriorityChannel;
+
+        PriorityChannel* m_channel;
+        bool m_min;
+        std::optional<value_type> m_result;
+        std::coroutine_handle<> m_handle;
+
+        /// 等待佇列是雙向串列，方便取消時移除
+        PopAwaiter* m_prev = nullptr;
+        PopAwaiter* m_next = nullptr;
+        bool m_waiting = false;
+
+        PopAwaiter(PriorityChannel* channel, bool min) : m_channel(channel), m_min(min) {}
+
+    public:
+        PopAwaiter(const PopAwaiter&) = delete;
+        PopAwaiter& operator=(const PopAwaiter&) = delete;
+
+        ~PopAwaiter() {
+            if (!m_waiting) return;
+
+            std::lock_guard<std::mutex> lock(m_channel->m_mutex);
+            if (m_waiting) m_channel->unlink(this);
+        }
+
+        /// 一律進入 await_suspend，在 lock 內判斷要不要暫停，避免漏掉同時發生的 push
+        bool await_ready() const noexcept { return false; }
+
+        /// @return `true`，暫停；`false`，已經拿到結果，不暫停
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::lock_guard<std::mutex> lock(m_channel->m_mutex);
+
+            Heap& heap = m_channel->m_heap;
+            if (heap.size() != 0) {
+                m_result = m_min ? heap.popMin() : heap.popMax();
+                return false;
+            }
+            if (m_channel->m_closed) return false;
+
+            m_handle = h;
+            m_channel->link(this);
+            return true;
+        }
+
+        std::optional<value_type> await_resume() { return std::move(m_result); }
+    };
+
+private:
+    std::mutex m_mutex;
+    Heap m_heap;
+    bool m_closed = false;
+
+    /// 等待佇列的頭尾
+    PopAwaiter* m_first = nullptr;
+    PopAwaiter* m_last = nullptr;
+
+public:
+    PriorityChannel() = default;
+    PriorityChannel(const PriorityChannel&) = delete;
+    PriorityChannel& operator=(const PriorityChannel&) = delete;
+
+    /// @brief 等待並取出最小值
+    /// @return awaitable，`co_await` 的結果為 `std::optional<value_type>`
+    PopAwaiter popMin() { return PopAwaiter(this, true); }
+
+    /// @brief 等待並取出最大值
+    /// @return awaitable，`co_await` 的結果為 `std::optional<value_type>`
+    PopAwaiter popMax() { return PopAwaiter(this, false); }
+
+    /// @brief 放入值。如果有 consumer 在等，直接交給它並在目前的 thread 上 resume
+    /// @throw std::logic_error - 如果 channel 已經被關閉
+    void push(const value_type& value) {
+        PopAwaiter* waiter;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closed) throw std::logic_error("PriorityChannel::push - channel is closed");
+
+            waiter = m_first;
+            if (waiter == nullptr) {
+                m_heap.push(value);
+                return;
+            }
+
+            // 等待中代表 heap 是空的，所以 value 同時是最小值和最大值
+            unlink(waiter);
+            waiter->m_result = value;
+        }
+        waiter->m_handle.resume();
+    }
+
+    /// @brief 不等待，嘗試取出最小值
+    /// @return 沒有值時為 `std::nullopt`
+    std::optional<value_type> tryPopMin() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_heap.size() == 0) return std::nullopt;
+        return m_heap.popMin();
+    }
+
+    /// @brief 不等待，嘗試取出最大值
+    /// @return 沒有值時為 `std::nullopt`
+    std::optional<value_type> tryPopMax() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_heap.size() == 0) return std::nullopt;
+        return m_heap.popMax();
+    }
+
+    /// @brief 關閉 channel，之後不能再 push。所有等待中的 consumer 會收到 `std::nullopt`；channel 中剩下的值仍然可以被取出
+    void close() {
+        PopAwaiter* waiters;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+
+            waiters = m_first;
+            for (PopAwaiter* w = m_first; w != nullptr; w = w->m_next) w->m_waiting = false;
+            m_first = m_last = nullptr;
+        }
+
+        // resume 後 awaiter 可能被釋放，所以要先取出 next
+        while (waiters != nullptr) {
+            PopAwaiter* next = waiters->m_next;
+            waiters->m_handle.resume();
+            waiters = next;
+        }
+    }
+
+    /// channel 中有幾個值
+    size_t size() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_heap.size();
+    }
+
+    /// 是否已經被關閉
+    bool closed() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_closed;
+    }
+
+private:
+    /// @brief 把 w 加到等待佇列的尾端
+    /// @pre 已經取得 m_mutex
+    void link(PopAwaiter* w) {
+        w->m_prev = m_last;
+        w->m_next = nullptr;
+        if (m_last) m_last->m_next = w;
+        else        m_first = w;
+        m_last = w;
+        w->m_waiting = true;
+    }
+
+    /// @brief 把 w 從等待佇列移除
+    /// @pre 已經取得 m_mutex
+    void unlink(PopAwaiter* w) {
+        if (w->m_prev) w->m_prev->m_next = w->m_next;
+        else           m_first = w->m_next;
+        if (w->m_next) w->m_next->m_prev = w->m_prev;
+        else           m_last = w->m_prev;
+        w->m_prev = w->m_next = nullptr;
+        w->m_waiting = false;
+    }
+};
+
+#endif // PRIORITYCHANNEL_H
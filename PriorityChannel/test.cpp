@@ -0,0 +1,168 @@
+#include "PriorityChannel.h"
+#include "Executor.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+    /// 取出 channel 中所有的值直到被關閉
+    template<typename Channel>
+    Task consume(SingleThreadExecutor& executor, Channel& channel, bool min, std::vector<int>& out) {
+        co_await executor.schedule();
+        while (auto v = co_await (min ? channel.popMin() : channel.popMax())) out.push_back(*v);
+        out.push_back(-1);
+    }
+
+    /// 由呼叫端持有 coroutine frame 的 task，用來測試 destroy 時的取消
+    struct OwnedTask {
+        struct promise_type {
+            OwnedTask get_return_object() { return OwnedTask{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        std::coroutine_handle<promise_type> m_handle;
+
+        ~OwnedTask() { if (m_handle) m_handle.destroy(); }
+    };
+
+    OwnedTask waitOnce(PriorityChannel<>& channel, int& out) {
+        auto v = co_await channel.popMin();
+        out = v ? *v : -1;
+    }
+}
+
+TEST(PriorityChannel, noSuspend) {
+    PriorityChannel<Deap> channel;
+    for (int v : {5, 1, 9, 3, 7}) channel.push(v);
+    ASSERT_TRUE(channel.size() == 5);
+
+    std::vector<int> got;
+    [](PriorityChannel<Deap>& ch, std::vector<int>& out) -> Task {
+        out.push_back(*co_await ch.popMin());
+        out.push_back(*co_await ch.popMax());
+        out.push_back(*co_await ch.popMin());
+    }(channel, got);
+
+    // channel 中有值，所以 coroutine 不會暫停，直接做完
+    ASSERT_TRUE((got == std::vector<int>{1, 9, 3}));
+    ASSERT_TRUE(*channel.tryPopMax() == 7);
+    ASSERT_TRUE(*channel.tryPopMin() == 5);
+    ASSERT_FALSE(channel.tryPopMin().has_value());
+}
+
+TEST(PriorityChannel, singleThreadExecutor) {
+    SingleThreadExecutor executor;
+    PriorityChannel<> channel;
+    std::vector<int> mins, maxs;
+
+    consume(executor, channel, true, mins);
+    consume(executor, channel, false, maxs);
+    executor.run();
+
+    // 兩個 consumer 都在等，push 依先來先得交給它們，並直接 resume
+    channel.push(4);
+    ASSERT_TRUE((mins == std::vector<int>{4}));
+    channel.push(6);
+    ASSERT_TRUE((maxs == std::vector<int>{6}));
+
+    // consumer 都在等的時候才會直接交出去；先放進 channel 的值照優先順序取出
+    channel.push(2);
+    channel.push(8);
+    ASSERT_TRUE((mins == std::vector<int>{4, 2}));
+    ASSERT_TRUE((maxs == std::vector<int>{6, 8}));
+
+    channel.close();
+    ASSERT_TRUE(channel.closed());
+    ASSERT_TRUE((mins == std::vector<int>{4, 2, -1}));
+    ASSERT_TRUE((maxs == std::vector<int>{6, 8, -1}));
+    ASSERT_THROW(channel.push(1), std::logic_error);
+}
+
+TEST(PriorityChannel, drainAfterClose) {
+    SingleThreadExecutor executor;
+    PriorityChannel<> channel;
+    for (int v : {3, 1, 2}) channel.push(v);
+    channel.close();
+
+    // 關閉後，剩下的值仍然依序取出，最後才收到 nullopt
+    std::vector<int> got;
+    consume(executor, channel, true, got);
+    executor.run();
+    ASSERT_TRUE((got == std::vector<int>{1, 2, 3, -1}));
+}
+
+TEST(PriorityChannel, cancel) {
+    PriorityChannel<> channel;
+    int first = 0, second = 0;
+    {
+        OwnedTask a = waitOnce(channel, first);
+        OwnedTask b = waitOnce(channel, second);
+        // 手動 destroy a，模擬取消等待中的 consumer
+        a.m_handle.destroy();
+        a.m_handle = nullptr;
+
+        channel.push(10);
+        ASSERT_TRUE(first == 0);
+        ASSERT_TRUE(second == 10);
+    }
+
+    // b 已經結束；沒有人在等，所以值留在 channel
+    channel.push(20);
+    ASSERT_TRUE(channel.size() == 1);
+
+    {
+        OwnedTask c = waitOnce(channel, first);
+        ASSERT_TRUE(first == 20);
+        OwnedTask d = waitOnce(channel, second);
+    }
+    // d 被 destroy 時已經從等待佇列移除，close 不會 resume 它
+    channel.close();
+    ASSERT_TRUE(second == 10);
+}
+
+TEST(PriorityChannel, threadPoolExecutor) {
+    const int producers = 4, perProducer = 5000, consumers = 4;
+
+    PriorityChannel<> channel;
+    std::vector<std::vector<int>> got(consumers);
+    std::atomic<int> finished{ 0 };
+    {
+        ThreadPoolExecutor executor(3);
+        for (int c = 0; c < consumers; ++c) {
+            [](ThreadPoolExecutor& ex, PriorityChannel<>& ch, std::vector<int>& out, std::atomic<int>& done, bool min) -> Task {
+                co_await ex.schedule();
+                while (auto v = co_await (min ? ch.popMin() : ch.popMax())) {
+                    out.push_back(*v);
+                    // 偶爾換到其他 worker thread 繼續
+                    if (out.size() % 64 == 0) co_await ex.schedule();
+                }
+                done.fetch_add(1);
+            }(executor, channel, got[c], finished, c % 2 == 0);
+        }
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&channel, p] {
+                for (int i = 0; i < perProducer; ++i) channel.push(p * perProducer + i);
+            });
+        }
+        for (auto& t : threads) t.join();
+
+        channel.close();
+        while (finished.load() != consumers) std::this_thread::yield();
+    }
+
+    // 每個值剛好被取出一次
+    std::vector<int> all;
+    for (auto& v : got) all.insert(all.end(), v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    ASSERT_TRUE(all.size() == size_t(producers * perProducer));
+    for (int i = 0; i < producers * perProducer; ++i) ASSERT_TRUE(all[i] == i);
+}
@@ -0,0 +1,249 @@
+/**
+ * @file PriorityPool.h
+ * @brief 每個 worker 各有一個 double-ended priority queue 的 work-stealing thread pool
+ */
+#ifndef PRIORITYPOOL_H
+#define PRIORITYPOOL_H
+
+#include "MinMaxHeap.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/// PriorityPool 的設定
+struct PriorityPoolOptions {
+    /// worker thread 的數量
+    size_t threads = 4;
+    /// 每從自己的佇列取 rescueEvery 次，就有一次改從最大端（優先度最低）取，0 代表不做
+    size_t rescueEvery = 16;
+    /// 每送出 agingPeriod 個工作，之後送出的工作優先度就降低 1 級，讓等待中的舊工作相對變得比較優先；0 代表不做
+    size_t agingPeriod = 0;
+};
+
+/**
+ * @brief 依優先度執行工作的 work-stealing thread pool
+ * @tparam Heap - 每個 worker 佇列使用的 heap 樣板，例如 BasicMinMaxHeap 或 BasicDeap
+ * @details
+ * priority 越小越優先。每個 worker 有自己的佇列：Heap 中放目前有工作的優先度（每種一個），
+ * 每個優先度各有一個 FIFO，所以不論從哪一端取，相同優先度的工作都是先送出的先取出：
+ * - submit：在 worker 上呼叫時放進自己的佇列，否則輪流放進各個 worker 的佇列
+ * - worker 平常從自己的佇列 popMin；每 rescueEvery 次改成 popMax，取出優先度最低的工作中等最久的一個，
+ *   所以即使一直有相同的低優先度工作送進來，最舊的也不會永遠等下去
+ * - 自己的佇列空了就去其他 worker 的佇列偷工作，從對方的最大端（popMax）拿，
+ *   不會搶走對方馬上就要執行的高優先度工作，也順便消化等最久的低優先度工作
+ * - aging：工作的 key 是 priority + 已送出的工作數 / agingPeriod，越晚送出的工作 key 越大，
+ *   所以舊工作最後一定會排到前面。key 是 int64_t，要送出接近 2^63 個工作才會溢位，不需要飽和或重新編號
+ *
+ * 工作不能丟出例外，否則會呼叫 std::terminate。解構時會先執行完所有已經送出的工作。
+ */
+template<template<typename> class Heap = BasicMinMaxHeap>
+class PriorityPool {
+public:
+    typedef std::function<void()> task_type;
+
+private:
+    /// 優先度的 double-ended priority queue，每個優先度各有一個 FIFO
+    class Queue {
+        /// 目前有工作的優先度，每種一個
+        Heap<int64_t> m_keys;
+        std::unordered_map<int64_t, std::deque<task_type>> m_tasks;
+        size_t m_size = 0;
+
+    public:
+        void push(int64_t key, task_type task) {
+            std::deque<task_type>& fifo = m_tasks[key];
+            if (fifo.empty()) m_keys.push(key);
+            fifo.push_back(std::move(task));
+            ++m_size;
+        }
+
+        /// 取出優先度最高（key 最小）的工作中最早送出的一個
+        task_type popMin() { return pop(m_keys.peekMin(), false); }
+
+        /// 取出優先度最低（key 最大）的工作中最早送出的一個
+        task_type popMax() { return pop(m_keys.peekMax(), true); }
+
+        size_t size() const { return m_size; }
+
+    private:
+        task_type pop(int64_t key, bool max) {
+            auto it = m_tasks.find(key);
+            task_type task = std::move(it->second.front());
+            it->second.pop_front();
+            --m_size;
+
+            if (it->second.empty()) {
+                m_tasks.erase(it);
+                if (max) m_keys.popMax();
+                else     m_keys.popMin();
+            }
+            return task;
+        }
+    };
+
+    struct Worker {
+        std::mutex m_mutex;
+        Queue m_queue;
+        /// 從自己的佇列取了幾次
+        size_t m_pops = 0;
+    };
+
+    PriorityPoolOptions m_options;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    /// 在佇列中、還沒被取出的工作數
+    std::atomic<size_t> m_queued{ 0 };
+    /// 已經送出、還沒執行完的工作數
+    std::atomic<size_t> m_unfinished{ 0 };
+    /// 送出過幾個工作，用來計算 aging 和輪流選擇佇列
+    std::atomic<uint64_t> m_submitted{ 0 };
+    std::atomic<size_t> m_steals{ 0 };
+
+    /// 閒置的 worker 在這裡等新的工作
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    /// wait() 在這裡等所有工作執行完
+    std::condition_variable m_idle;
+    bool m_stop = false;
+
+    /// 目前的 thread 是哪一個 pool 的第幾個 worker
+    static thread_local const PriorityPool* t_pool;
+    static thread_local size_t t_index;
+
+public:
+    /// @brief 建立 pool 並啟動 worker
+    /// @throw std::invalid_argument - 如果 options.threads 為 0
+    explicit PriorityPool(const PriorityPoolOptions& options = PriorityPoolOptions()) : m_options(options) {
+        if (options.threads == 0) throw std::invalid_argument("PriorityPool - threads must be positive");
+
+        for (size_t i = 0; i < options.threads; ++i) m_workers.emplace_back(new Worker());
+        for (size_t i = 0; i < options.threads; ++i) m_threads.emplace_back([this, i] { work(i); });
+    }
+
+    /// 執行完所有已經送出的工作後才結束
+    ~PriorityPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads) t.join();
+    }
+
+    PriorityPool(const PriorityPool&) = delete;
+    PriorityPool& operator=(const PriorityPool&) = delete;
+
+    /// @brief 送出工作
+    /// @param priority - 優先度，越小越優先
+    /// @param task - 要執行的工作，不能丟出例外
+    void submit(int32_t priority, task_type task) {
+        const uint64_t n = m_submitted.fetch_add(1, std::memory_order_relaxed);
+        const size_t index = t_pool == this ? t_index : static_cast<size_t>(n % m_workers.size());
+
+        m_unfinished.fetch_add(1, std::memory_order_relaxed);
+        {
+            Worker& w = *m_workers[index];
+            std::lock_guard<std::mutex> lock(w.m_mutex);
+            w.m_queue.push(key(priority, n, m_options.agingPeriod), std::move(task));
+        }
+        m_queued.fetch_add(1, std::memory_order_seq_cst);
+
+        // 取得 m_sleepMutex 再通知，避免 worker 檢查完 m_queued 但還沒開始等待時漏掉通知
+        { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+        m_wake.notify_one();
+    }
+
+    /// @brief 等待所有已經送出的工作執行完
+    /// @note 不能在 worker 上呼叫
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_idle.wait(lock, [this] { return m_unfinished.load(std::memory_order_acquire) == 0; });
+    }
+
+    /// worker 的數量
+    size_t threads() const { return m_workers.size(); }
+
+    /// 從其他 worker 偷到幾個工作
+    size_t steals() const { return m_steals.load(std::memory_order_relaxed); }
+
+    /// @brief 第 submitted 個送出（從 0 開始）、優先度為 priority 的工作在佇列中的 key，越小越先執行
+    /// @param agingPeriod - PriorityPoolOptions::agingPeriod，0 代表不做 aging
+    static int64_t key(int32_t priority, uint64_t submitted, size_t agingPeriod) {
+        if (agingPeriod == 0) return priority;
+        return int64_t(priority) + int64_t(submitted / agingPeriod);
+    }
+
+private:
+    void work(size_t index) {
+        t_pool = this;
+        t_index = index;
+
+        task_type task;
+        while (true) {
+            if (popLocal(index, task) || steal(index, task)) {
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                run(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wake.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_seq_cst) != 0; });
+            if (m_stop && m_queued.load(std::memory_order_seq_cst) == 0) return;
+        }
+    }
+
+    /// @brief 從自己的佇列取出工作，每 rescueEvery 次從最大端取
+    bool popLocal(size_t index, task_type& task) {
+        Worker& w = *m_workers[index];
+        std::lock_guard<std::mutex> lock(w.m_mutex);
+        if (w.m_queue.size() == 0) return false;
+
+        const bool rescue = m_options.rescueEvery != 0 && ++w.m_pops % m_options.rescueEvery == 0;
+        task = rescue ? w.m_queue.popMax() : w.m_queue.popMin();
+        return true;
+    }
+
+    /// @brief 從其他 worker 佇列的最大端偷一個工作
+    bool steal(size_t index, task_type& task) {
+        const size_t n = m_workers.size();
+        for (size_t i = 1; i < n; ++i) {
+            Worker& victim = *m_workers[(index + i) % n];
+            std::lock_guard<std::mutex> lock(victim.m_mutex);
+            if (victim.m_queue.size() == 0) continue;
+
+            task = victim.m_queue.popMax();
+            m_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void run(task_type& task) noexcept {
+        task();
+        task = nullptr;
+
+        if (m_unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_idle.notify_all();
+        }
+    }
+};
+
+template<template<typename> class Heap>
+thread_local const PriorityPool<Heap>* PriorityPool<Heap>::t_pool = nullptr;
+
+template<template<typename> class Heap>
+thread_local size_t PriorityPool<Heap>::t_index = 0;
+
+#endif // PRIORITYPOOL_H
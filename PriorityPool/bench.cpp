@@ -0,0 +1,174 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 PriorityPool、FIFO thread pool 和共用一個 std::priority_queue 的 thread pool 的吞吐量與等待時間
+ * @note 結果受 CPU 核心數影響很大，核心數少於 thread 數時，數字主要反映排程而不是同步的成本
+ */
+#include "PriorityPool.h"
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+static const size_t THREADS = 4;
+static const size_t TASKS = 1 << 17;
+static const int PRIORITIES = 8;    ///< 優先度為 0 ~ PRIORITIES - 1
+static const int WORK = 200;        ///< 每個工作空轉幾次
+
+typedef std::chrono::steady_clock Clock;
+
+/// 共用一個佇列的 thread pool；Queue 決定取出的順序
+template<typename Queue>
+class SharedPool {
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    Queue m_queue;
+    size_t m_unfinished = 0;
+    bool m_stop = false;
+    std::vector<std::thread> m_threads;
+
+public:
+    explicit SharedPool(size_t threads) {
+        for (size_t i = 0; i < threads; ++i) m_threads.emplace_back([this] { work(); });
+    }
+
+    ~SharedPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_threads) t.join();
+    }
+
+    void submit(int priority, std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push(priority, std::move(task));
+            ++m_unfinished;
+        }
+        m_wake.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_unfinished == 0; });
+    }
+
+private:
+    void work() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+
+            std::function<void()> task = m_queue.pop();
+            lock.unlock();
+            task();
+            lock.lock();
+            if (--m_unfinished == 0) m_idle.notify_all();
+        }
+    }
+};
+
+/// 忽略優先度的 FIFO 佇列
+class FifoQueue {
+    std::deque<std::function<void()>> m_queue;
+
+public:
+    void push(int, std::function<void()> task) { m_queue.push_back(std::move(task)); }
+    std::function<void()> pop() { auto t = std::move(m_queue.front()); m_queue.pop_front(); return t; }
+    bool empty() const { return m_queue.empty(); }
+};
+
+/// std::priority_queue，相同優先度時先送出的先取出
+class StdPriorityQueue {
+    typedef std::tuple<int, uint64_t, std::function<void()>> Item;
+
+    struct Later {
+        bool operator()(const Item& a, const Item& b) const {
+            return std::tie(std::get<0>(a), std::get<1>(a)) > std::tie(std::get<0>(b), std::get<1>(b));
+        }
+    };
+
+    std::priority_queue<Item, std::vector<Item>, Later> m_queue;
+    uint64_t m_next = 0;
+
+public:
+    void push(int priority, std::function<void()> task) { m_queue.emplace(priority, m_next++, std::move(task)); }
+    std::function<void()> pop() { auto t = std::move(std::get<2>(m_queue.top())); m_queue.pop(); return t; }
+    bool empty() const { return m_queue.empty(); }
+};
+
+/// 排序後第 q 分位的值
+static double percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * v.size()))];
+}
+
+/**
+ * @brief 一個 thread 一口氣送出 TASKS 個隨機優先度的工作，量測全部執行完的時間，以及每個工作從送出到開始執行的等待時間
+ */
+template<typename Pool>
+void run(const char* name, Pool& pool) {
+    std::mt19937 rng(1);
+    std::vector<int> priorities(TASKS);
+    for (int& p : priorities) p = static_cast<int>(rng() % PRIORITIES);
+
+    std::vector<double> latency(TASKS);
+    double seconds = Benchmark::measure([&] {
+        for (size_t i = 0; i < TASKS; ++i) {
+            const Clock::time_point submitted = Clock::now();
+            pool.submit(priorities[i], [&latency, i, submitted] {
+                latency[i] = std::chrono::duration<double, std::micro>(Clock::now() - submitted).count();
+                volatile int spin = 0;
+                for (int k = 0; k < WORK; ++k) spin = spin + 1;
+            });
+        }
+        pool.wait();
+    });
+    Benchmark::report(name, TASKS, seconds);
+
+    std::vector<double> high, low;
+    for (size_t i = 0; i < TASKS; ++i) {
+        if (priorities[i] == 0)              high.push_back(latency[i]);
+        if (priorities[i] == PRIORITIES - 1) low.push_back(latency[i]);
+    }
+    printf("    wait (us): priority 0 p50 %10.0f p99 %10.0f | priority %d p50 %10.0f p99 %10.0f max %10.0f\n",
+           percentile(high, 0.5), percentile(high, 0.99), PRIORITIES - 1,
+           percentile(low, 0.5), percentile(low, 0.99), percentile(low, 1.0));
+}
+
+int main() {
+    printf("%zu threads, %zu tasks, %d priorities\n", THREADS, TASKS, PRIORITIES);
+
+    {
+        SharedPool<FifoQueue> pool(THREADS);
+        run("FIFO pool", pool);
+    }
+    {
+        SharedPool<StdPriorityQueue> pool(THREADS);
+        run("shared std::priority_queue", pool);
+    }
+    for (size_t rescue : {0, 16}) {
+        PriorityPool<> pool(PriorityPoolOptions{ THREADS, rescue, 0 });
+        const std::string name = "PriorityPool, rescueEvery = " + std::to_string(rescue);
+        run(name.c_str(), pool);
+        printf("    steals: %zu\n", pool.steals());
+    }
+    {
+        PriorityPool<> pool(PriorityPoolOptions{ THREADS, 0, TASKS / 16 });
+        run("PriorityPool, agingPeriod = TASKS / 16", pool);
+    }
+    return 0;
+}
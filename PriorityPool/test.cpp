@@ -0,0 +1,110 @@
+#include "PriorityPool.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/// @brief 只有一個 worker 的 pool：先送出一個擋住 worker 的工作，等其他工作都送出後再放行，確認執行的順序
+/// @param submit - 送出工作的 callable，參數為記錄順序的 vector
+template<template<typename> class Heap = BasicMinMaxHeap, typename Submit>
+std::vector<int> runOrder(PriorityPoolOptions options, Submit submit) {
+    options.threads = 1;
+    PriorityPool<Heap> pool(options);
+
+    std::atomic<bool> open{ false };
+    pool.submit(INT32_MIN, [&] { while (!open.load()) std::this_thread::yield(); });
+
+    std::vector<int> order;
+    submit(pool, order);
+    open = true;
+    pool.wait();
+    return order;
+}
+
+TEST(PriorityPool, priorityOrder) {
+    ASSERT_THROW(PriorityPool<>(PriorityPoolOptions{ 0, 0, 0 }), std::invalid_argument);
+
+    auto order = runOrder<BasicDeap>(PriorityPoolOptions{ 1, 0, 0 }, [](PriorityPool<BasicDeap>& pool, std::vector<int>& order) {
+        int id = 0;
+        for (int p : {3, 1, 2, 1, 0, 3}) {
+            pool.submit(p, [&order, id] { order.push_back(id); });
+            ++id;
+        }
+    });
+    // 相同優先度時先送出的先執行
+    ASSERT_TRUE((order == std::vector<int>{4, 1, 3, 2, 0, 5}));
+}
+
+TEST(PriorityPool, rescue) {
+    // 擋住 worker 的工作是第 1 次，之後每 3 次中的第 3 次從最大端取
+    auto order = runOrder(PriorityPoolOptions{ 1, 3, 0 }, [](PriorityPool<>& pool, std::vector<int>& order) {
+        for (int p : {0, 1, 2, 3, 4, 5}) pool.submit(p, [&order, p] { order.push_back(p); });
+    });
+    ASSERT_TRUE((order == std::vector<int>{0, 5, 1, 2, 4, 3}));
+}
+
+TEST(PriorityPool, rescueOldest) {
+    // 低優先度的工作 100 ~ 102 優先度相同，從最大端取時要先取出等最久的
+    auto order = runOrder<BasicDeap>(PriorityPoolOptions{ 1, 3, 0 }, [](PriorityPool<BasicDeap>& pool, std::vector<int>& order) {
+        int low = 100, high = 0;
+        for (int p : {5, 0, 5, 0, 5, 0, 0}) {
+            const int id = p == 5 ? low++ : high++;
+            pool.submit(p, [&order, id] { order.push_back(id); });
+        }
+    });
+    ASSERT_TRUE((order == std::vector<int>{0, 100, 1, 2, 101, 3, 102}));
+}
+
+TEST(PriorityPool, aging) {
+    // 第 n 個送出的工作 key 為 priority + n：低優先度的工作 A（n = 1，key 6）排在 key 為 2 ~ 5 的工作之後，
+    // 和 key 同樣是 6 的工作比較時，因為比較早送出所以先執行
+    auto order = runOrder(PriorityPoolOptions{ 1, 0, 1 }, [](PriorityPool<>& pool, std::vector<int>& order) {
+        pool.submit(5, [&order] { order.push_back(-1); });
+        for (int n = 2; n < 10; ++n) pool.submit(0, [&order, n] { order.push_back(n); });
+    });
+    ASSERT_TRUE((order == std::vector<int>{2, 3, 4, 5, -1, 6, 7, 8, 9}));
+}
+
+TEST(PriorityPool, agingKey) {
+    // 送出超過 2^31 個工作後，key 仍然隨著送出的順序增加，不會飽和成 FIFO
+    const uint64_t n = uint64_t(1) << 40;
+    ASSERT_TRUE(PriorityPool<>::key(3, n, 0) == 3);
+    ASSERT_TRUE(PriorityPool<>::key(0, n, 1) < PriorityPool<>::key(0, n + 1, 1));
+    ASSERT_TRUE(PriorityPool<>::key(1, n, 1) > PriorityPool<>::key(0, n, 1));
+    ASSERT_TRUE(PriorityPool<>::key(INT32_MAX, n, 1) > PriorityPool<>::key(INT32_MAX - 1, n, 1));
+    ASSERT_TRUE(PriorityPool<>::key(INT32_MIN, n, 4) == INT32_MIN + int64_t(n / 4));
+}
+
+TEST(PriorityPool, steal) {
+    PriorityPool<> pool(PriorityPoolOptions{ 2, 16, 0 });
+    std::atomic<int> done{ 0 };
+
+    // 在 worker 上送出的工作放進自己的佇列；這個 worker 等到有子工作完成才結束，所以子工作只能被另一個 worker 偷走
+    pool.submit(0, [&] {
+        for (int i = 0; i < 100; ++i) pool.submit(i, [&] { ++done; });
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (done.load() == 0 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+    });
+    pool.wait();
+
+    ASSERT_TRUE(done.load() == 100);
+    ASSERT_TRUE(pool.steals() >= 1);
+}
+
+TEST(PriorityPool, drainOnDestroy) {
+    std::atomic<int> done{ 0 };
+    {
+        PriorityPool<> pool(PriorityPoolOptions{ 4, 4, 8 });
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit(i % 7, [&pool, &done, i] {
+                for (int j = 0; j < 10; ++j) pool.submit(j, [&done] { ++done; });
+                ++done;
+            });
+        }
+    }
+    ASSERT_TRUE(done.load() == 11000);
+}
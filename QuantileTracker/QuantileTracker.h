@@ -0,0 +1,228 @@
+/**
+ * @file QuantileTracker.h
+ * @brief 以兩個 double-ended priority queue 追蹤資料流的分位數（中位數、p90、p99……）
+ */
+#ifndef QUANTILETRACKER_H
+#define QUANTILETRACKER_H
+
+#include "MinMaxHeap.h"
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <stdexcept>
+#include <stddef.h>
+
+/**
+ * @brief 追蹤資料流中第 q 分位數的值
+ * @tparam Heap - double-ended priority queue，需要提供 push、popMin、popMax、peekMin、peekMax、size，例如 MinMaxHeap 或 Deap
+ * @details
+ * 將資料分成兩半：
+ * - m_lower 存排名「小於等於」目標排名的值，它的最大值就是答案
+ * - m_upper 存其餘的值，它的最小值是下一個排名的值
+ *
+ * 有 n 個值時，目標排名（從 1 開始）為 floor(q * (n - 1)) + 1。
+ *
+ * 有兩種模式：
+ * - Mode::Exact：只看最近 capacity 個值（滑動視窗），結果是精確的。
+ *   離開視窗的值不會馬上從 heap 中移除，而是先記錄下來（延遲刪除），等它跑到 heap 的任一端時再移除。
+ *   卡在 heap 中間的延遲刪除值比視窗內的值還多時，直接用視窗的內容重建兩個 heap（O(capacity)），
+ *   所以記憶體不超過視窗大小的常數倍，攤銷後每次 push 仍是 O(log capacity)。
+ * - Mode::Approximate：看所有的值，但最多只保留 capacity 個。
+ *   超過時從離目標排名最遠的兩端（m_lower 的最小值或 m_upper 的最大值）丟掉，只記錄丟了幾個。
+ *   只要分位數不會跑到被丟掉的範圍，結果仍是精確的；否則回傳保留下來的值中最接近的那個。
+ */
+template<typename Heap = MinMaxHeap>
+class QuantileTracker {
+public:
+    typedef typename Heap::value_type value_type;
+
+    /// 追蹤的模式
+    enum class Mode {
+        Exact,       ///< 滑動視窗，精確值
+        Approximate  ///< 固定記憶體，近似值
+    };
+
+private:
+    double m_q;
+    Mode m_mode;
+    size_t m_capacity;
+
+    Heap m_lower;
+    Heap m_upper;
+
+    /// m_lower、m_upper 中扣除延遲刪除後的數量
+    size_t m_lowerSize = 0, m_upperSize = 0;
+
+    /// Exact：視窗內的值，依照加入的順序
+    std::deque<value_type> m_window;
+    /// Exact：m_lower、m_upper 中已經離開視窗，但還沒被移除的值及其數量
+    std::unordered_map<value_type, size_t> m_lowerRemoved, m_upperRemoved;
+
+    /// Approximate：從 m_lower 的最小端、m_upper 的最大端丟掉的數量
+    size_t m_droppedLow = 0, m_droppedHigh = 0;
+
+public:
+    /// @brief 建立 QuantileTracker
+    /// @param q - 分位數，介於 [0, 1]，例如中位數為 0.5
+    /// @param capacity - Mode::Exact 時為視窗大小；Mode::Approximate 時為最多保留幾個值
+    /// @param mode - 模式
+    /// @throw std::invalid_argument - 如果 q 不在 [0, 1] 或 capacity 為 0
+    QuantileTracker(double q, size_t capacity, Mode mode = Mode::Exact)
+        : m_q(q), m_mode(mode), m_capacity(capacity)
+    {
+        if (!(0 <= q && q <= 1)) throw std::invalid_argument("QuantileTracker - q must be in [0, 1]");
+        if (capacity == 0)       throw std::invalid_argument("QuantileTracker - capacity must be positive");
+    }
+
+    /// @brief 加入新的值
+    /// @param v - 新的值
+    void push(const value_type& v) {
+        // m_lower 可能因為 Approximate 丟掉值而變空，這時改跟 m_upper 的最小值比
+        const bool toLower = m_lowerSize > 0 ? !(m_lower.peekMax() < v)
+                                             : (m_upperSize == 0 || !(m_upper.peekMin() < v));
+
+        if (toLower) { m_lower.push(v); ++m_lowerSize; }
+        else         { m_upper.push(v); ++m_upperSize; }
+
+        if (m_mode == Mode::Exact) {
+            m_window.push_back(v);
+            if (m_window.size() > m_capacity) expire();
+        }
+
+        rebalance();
+
+        if (m_mode == Mode::Approximate) {
+            while (m_lowerSize + m_upperSize > m_capacity) evict();
+        }
+        else if (stored() - size() > size()) {
+            rebuild();
+        }
+    }
+
+    /// @brief 回傳目前的分位數
+    /// @throw std::out_of_range - 如果還沒有任何值
+    const value_type& quantile() const {
+        if (m_lowerSize > 0) return m_lower.peekMax();
+        if (m_upperSize > 0) return m_upper.peekMin(); // 目標排名已經被丟掉，回傳最接近的值
+        throw std::out_of_range("QuantileTracker::quantile - no element");
+    }
+
+    /// 目前保留的值有幾個（不含延遲刪除的值）
+    size_t size() const { return m_lowerSize + m_upperSize; }
+
+    /// heap 中實際存放的值有幾個（含延遲刪除的值）
+    size_t stored() const { return m_lower.size() + m_upper.size(); }
+
+    /// 分位數是從幾個值算出來的。Mode::Exact 時為視窗內的數量；Mode::Approximate 時為所有加入過的數量
+    size_t count() const { return size() + m_droppedLow + m_droppedHigh; }
+
+private:
+    /// 目前的目標排名（從 1 開始）
+    size_t targetRank() const {
+        const size_t n = count();
+        return n == 0 ? 0 : static_cast<size_t>(m_q * (n - 1)) + 1;
+    }
+
+    /// @brief 移除 heap 最大端已被延遲刪除的值
+    static void pruneMax(Heap& heap, std::unordered_map<value_type, size_t>& removed) {
+        while (heap.size() != 0) {
+            auto it = removed.find(heap.peekMax());
+            if (it == removed.end()) return;
+
+            heap.popMax();
+            if (--it->second == 0) removed.erase(it);
+        }
+    }
+
+    /// @brief 移除 heap 最小端已被延遲刪除的值
+    static void pruneMin(Heap& heap, std::unordered_map<value_type, size_t>& removed) {
+        while (heap.size() != 0) {
+            auto it = removed.find(heap.peekMin());
+            if (it == removed.end()) return;
+
+            heap.popMin();
+            if (--it->second == 0) removed.erase(it);
+        }
+    }
+
+    /// @brief 移除四個端點上已被延遲刪除的值，使 m_lower 的最大值和 m_upper 的最小值都是有效的
+    void prune() {
+        if (m_lowerRemoved.empty() && m_upperRemoved.empty()) return;
+
+        pruneMax(m_lower, m_lowerRemoved);
+        pruneMin(m_lower, m_lowerRemoved);
+        pruneMin(m_upper, m_upperRemoved);
+        pruneMax(m_upper, m_upperRemoved);
+    }
+
+    /**
+     * @brief Exact：讓最舊的值離開視窗
+     * @details
+     * m_upper 中的值都「大於等於」m_lower 的最大值，所以：
+     * - 舊值「小於」m_lower 的最大值 -> 一定在 m_lower
+     * - 舊值「等於」m_lower 的最大值 -> 不管它實際在哪，從 m_lower 刪除一個同樣的值都是等價的
+     * - 否則在 m_upper
+     */
+    void expire() {
+        const value_type old = std::move(m_window.front());
+        m_window.pop_front();
+
+        if (m_lowerSize > 0 && !(m_lower.peekMax() < old)) {
+            ++m_lowerRemoved[old];
+            --m_lowerSize;
+        }
+        else {
+            ++m_upperRemoved[old];
+            --m_upperSize;
+        }
+
+        prune();
+    }
+
+    /// @brief Exact：丟掉所有延遲刪除的值，用視窗的內容重建 m_lower、m_upper，兩邊的數量不變
+    void rebuild() {
+        std::vector<value_type> values(m_window.begin(), m_window.end());
+        auto mid = values.begin() + m_lowerSize;
+        std::nth_element(values.begin(), mid, values.end());
+
+        m_lower = Heap(values.begin(), mid);
+        m_upper = Heap(mid, values.end());
+        m_lowerRemoved.clear();
+        m_upperRemoved.clear();
+    }
+
+    /// @brief 在 m_lower 和 m_upper 之間搬移，使「m_lower 的數量 + 丟掉的小值」等於目標排名
+    void rebalance() {
+        const size_t target = targetRank();
+
+        while (m_droppedLow + m_lowerSize > target && m_lowerSize > 0) {
+            m_upper.push(m_lower.popMax());
+            --m_lowerSize;
+            ++m_upperSize;
+            pruneMax(m_lower, m_lowerRemoved);
+        }
+
+        while (m_droppedLow + m_lowerSize < target && m_upperSize > 0) {
+            m_lower.push(m_upper.popMin());
+            --m_upperSize;
+            ++m_lowerSize;
+            pruneMin(m_upper, m_upperRemoved);
+        }
+    }
+
+    /// @brief Approximate：從較多的一半丟掉離目標排名最遠的值
+    void evict() {
+        if (m_lowerSize > m_upperSize) {
+            m_lower.popMin();
+            --m_lowerSize;
+            ++m_droppedLow;
+        }
+        else {
+            m_upper.popMax();
+            --m_upperSize;
+            ++m_droppedHigh;
+        }
+    }
+};
+
+#endif // QUANTILETRACKER_H
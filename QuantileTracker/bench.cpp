@@ -0,0 +1,109 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 QuantileTracker 和「排序整個視窗」、「std::nth_element」的 push 吞吐量及查詢延遲
+ */
+#include "QuantileTracker.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+static const size_t N = 1000000;   ///< 資料流的長度
+static const size_t QUERIES = 1000; ///< 排序、nth_element 的查詢次數（太慢了，不能每次 push 都查）
+static const double Q = 0.99;
+
+template<typename Heap>
+static void benchTracker(const std::string& name, const std::vector<int>& data, size_t capacity,
+                         typename QuantileTracker<Heap>::Mode mode)
+{
+    {
+        QuantileTracker<Heap> tracker(Q, capacity, mode);
+        const double t = Benchmark::measure([&] {
+            for (int v : data) tracker.push(v);
+        });
+        Benchmark::report((name + " push").c_str(), data.size(), t);
+
+        const double tq = Benchmark::measure([&] {
+            for (size_t i = 0; i < data.size(); ++i) Benchmark::keep(tracker.quantile());
+        });
+        Benchmark::report((name + " query").c_str(), data.size(), tq);
+    }
+    {
+        QuantileTracker<Heap> tracker(Q, capacity, mode);
+        const double t = Benchmark::measure([&] {
+            for (int v : data) {
+                tracker.push(v);
+                Benchmark::keep(tracker.quantile());
+            }
+        });
+        Benchmark::report((name + " push + query").c_str(), data.size(), t);
+    }
+}
+
+/// 保留視窗，查詢時複製一份再用 select 找出分位數
+template<typename Select>
+static void benchBuffer(const std::string& name, const std::vector<int>& data, size_t window, Select select)
+{
+    std::deque<int> buffer;
+    const double pushTime = Benchmark::measure([&] {
+        for (int v : data) {
+            buffer.push_back(v);
+            if (buffer.size() > window) buffer.pop_front();
+        }
+    });
+
+    buffer.clear();
+    std::vector<int> scratch;
+    const size_t every = data.size() / QUERIES;
+    double queryTime = 0;
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        buffer.push_back(data[i]);
+        if (buffer.size() > window) buffer.pop_front();
+
+        if (i % every == every - 1) {
+            Benchmark::Timer timer;
+            scratch.assign(buffer.begin(), buffer.end());
+            const size_t rank = static_cast<size_t>(Q * (scratch.size() - 1));
+            Benchmark::keep(select(scratch, rank));
+            queryTime += timer.seconds();
+        }
+    }
+
+    Benchmark::report((name + " push").c_str(), data.size(), pushTime);
+    Benchmark::report((name + " query").c_str(), QUERIES, queryTime);
+}
+
+int main()
+{
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> dist(0, 1 << 20);
+    std::vector<int> data(N);
+    for (int& v : data) v = dist(gen);
+
+    for (size_t window : {1000, 100000}) {
+        printf("== p%g, window = %zu, %zu values ==\n", Q * 100, window, N);
+
+        benchTracker<MinMaxHeap>("QuantileTracker<MinMaxHeap> exact", data, window, QuantileTracker<MinMaxHeap>::Mode::Exact);
+        benchTracker<Deap>("QuantileTracker<Deap> exact", data, window, QuantileTracker<Deap>::Mode::Exact);
+
+        benchBuffer("sort buffer", data, window, [](std::vector<int>& v, size_t rank) {
+            std::sort(v.begin(), v.end());
+            return v[rank];
+        });
+        benchBuffer("std::nth_element", data, window, [](std::vector<int>& v, size_t rank) {
+            std::nth_element(v.begin(), v.begin() + rank, v.end());
+            return v[rank];
+        });
+    }
+
+    printf("== p%g, whole stream, budget = 1024 ==\n", Q * 100);
+    benchTracker<MinMaxHeap>("QuantileTracker<MinMaxHeap> approximate", data, 1024, QuantileTracker<MinMaxHeap>::Mode::Approximate);
+    benchTracker<Deap>("QuantileTracker<Deap> approximate", data, 1024, QuantileTracker<Deap>::Mode::Approximate);
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "QuantileTracker.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+/// 把 window 排序後直接取出第 q 分位數
+static int bruteForce(const std::deque<int>& window, double q) {
+    std::vector<int> sorted(window.begin(), window.end());
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[static_cast<size_t>(q * (sorted.size() - 1))];
+}
+
+template<typename Heap>
+static void testExact(double q, size_t window) {
+    QuantileTracker<Heap> tracker(q, window);
+    std::deque<int> expected;
+
+    for (int i = 0; i < 1000; ++i) {
+        const int v = rand() % 10;
+        tracker.push(v);
+
+        expected.push_back(v);
+        if (expected.size() > window) expected.pop_front();
+
+        ASSERT_TRUE(tracker.count() == expected.size());
+        ASSERT_TRUE(tracker.quantile() == bruteForce(expected, q)) << "q = " << q << ", window = " << window;
+    }
+}
+
+TEST(QuantileTracker, invalidArgument) {
+    ASSERT_THROW(QuantileTracker<>(-0.1, 10), std::invalid_argument);
+    ASSERT_THROW(QuantileTracker<>(1.1, 10), std::invalid_argument);
+    ASSERT_THROW(QuantileTracker<>(0.5, 0), std::invalid_argument);
+
+    QuantileTracker<> empty(0.5, 10);
+    ASSERT_THROW(empty.quantile(), std::out_of_range);
+}
+
+TEST(QuantileTracker, exactMinMaxHeap) {
+    unsigned seed = time(NULL);
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+
+    for (double q : {0.0, 0.1, 0.5, 0.9, 0.99, 1.0})
+        for (size_t window : {1, 2, 7, 64, 2000})
+            testExact<MinMaxHeap>(q, window);
+}
+
+TEST(QuantileTracker, exactDeap) {
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+
+    for (double q : {0.0, 0.1, 0.5, 0.9, 0.99, 1.0})
+        for (size_t window : {1, 2, 7, 64, 2000})
+            testExact<Deap>(q, window);
+}
+
+/// 值的範圍很大時，延遲刪除的值大多卡在 heap 中間，確認它們不會無限制地累積
+template<typename Heap>
+static void testLongStream() {
+    const size_t window = 1000;
+    QuantileTracker<Heap> tracker(0.9, window);
+    std::deque<int> expected;
+    std::mt19937 rng(5);
+
+    for (int i = 0; i < 200000; ++i) {
+        const int v = static_cast<int>(rng());
+        tracker.push(v);
+
+        expected.push_back(v);
+        if (expected.size() > window) expected.pop_front();
+
+        ASSERT_TRUE(tracker.stored() <= 2 * window + 1);
+        if (i % 997 == 0) {
+            ASSERT_TRUE(tracker.quantile() == bruteForce(expected, 0.9));
+        }
+    }
+}
+
+TEST(QuantileTracker, longStream) {
+    testLongStream<MinMaxHeap>();
+    testLongStream<Deap>();
+}
+
+TEST(QuantileTracker, approximate) {
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+
+    for (double q : {0.5, 0.9, 0.99}) {
+        QuantileTracker<> tracker(q, 256, QuantileTracker<>::Mode::Approximate);
+        std::deque<int> all;
+
+        for (int i = 0; i < 20000; ++i) {
+            const int v = rand() % 1000;
+            tracker.push(v);
+            all.push_back(v);
+
+            ASSERT_TRUE(tracker.size() <= 256);
+        }
+
+        ASSERT_TRUE(tracker.count() == all.size());
+
+        // 資料分佈不變時，分位數不會跑到被丟掉的範圍
+        const int expected = bruteForce(all, q);
+        ASSERT_NEAR(tracker.quantile(), expected, 10) << "q = " << q;
+    }
+}
+
+TEST(QuantileTracker, approximateWithinBudget) {
+    // 沒有超過記憶體上限時，結果是精確的
+    QuantileTracker<Deap> tracker(0.9, 1000, QuantileTracker<Deap>::Mode::Approximate);
+    std::deque<int> all;
+
+    for (int i = 0; i < 1000; ++i) {
+        const int v = rand() % 100;
+        tracker.push(v);
+        all.push_back(v);
+        ASSERT_TRUE(tracker.quantile() == bruteForce(all, 0.9));
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * @file RunLengthHeap.h
+ * @brief 將重複的值合併成 (值, 數量) 的 double-ended priority queue，適合值的種類很少的情況
+ */
+#ifndef RUNLENGTHHEAP_H
+#define RUNLENGTHHEAP_H
+
+#include "MinMaxHeap.h"
+#include <initializer_list>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include <stddef.h>
+
+/**
+ * @brief 重複的值只佔一個節點的 double-ended priority queue
+ * @tparam T - 元素的型別，需要支援 `<`、`>`、`==` 及 std::hash
+ * @tparam Heap - 存放不重複值的 heap 樣板，例如 BasicMinMaxHeap 或 BasicDeap
+ * @details
+ * m_heap 中每個值只出現一次，m_count 記錄每個值有幾個。
+ * - push 已經存在的值：只要把數量加 1，O(1)
+ * - popMin、popMax：把數量減 1，減到 0 時才真的從 m_heap 移除
+ *
+ * 所以 heap 的大小和 pop 時走過的層數只和「有幾種值」有關，和元素總數無關。
+ */
+template<typename T, template<typename> class Heap = BasicMinMaxHeap>
+class RunLengthHeap {
+public:
+    typedef T value_type;
+
+private:
+    Heap<value_type> m_heap;
+    std::unordered_map<value_type, size_t> m_count;
+    size_t m_size = 0;
+
+public:
+    /// 建立空的 RunLengthHeap
+    RunLengthHeap() = default;
+
+    /// @brief 從 [first, last) 建立 RunLengthHeap
+    /// @details 先數出每個值有幾個，再用 heap 的範圍建構子一次建好，O(n)
+    /// @tparam InputIt - 滿足 input iterator
+    /// @param first - 範圍的起點（包含）
+    /// @param last - 範圍的終點（不包含）
+    template<typename InputIt>
+    RunLengthHeap(InputIt first, InputIt last) {
+        std::vector<value_type> keys;
+        for (; first != last; ++first, ++m_size) {
+            if (m_count[*first]++ == 0) keys.push_back(*first);
+        }
+        m_heap = Heap<value_type>(keys.begin(), keys.end());
+    }
+
+    /// @brief 從初始化串列建立 RunLengthHeap
+    /// @param list - 初始化串列
+    RunLengthHeap(std::initializer_list<value_type> list) : RunLengthHeap(list.begin(), list.end()) {}
+
+    /// @brief 插入 count 個 value
+    /// @param value - 插入的值
+    /// @param count - 插入幾個
+    void push(const value_type& value, size_t count = 1) {
+        if (count == 0) return;
+
+        size_t& c = m_count[value];
+        if (c == 0) m_heap.push(value);
+        c += count;
+        m_size += count;
+    }
+
+    /// @brief 移除最小值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMin() {
+        if (m_size == 0) throw std::out_of_range("RunLengthHeap::popMin - no element");
+        return take(m_heap.peekMin(), true);
+    }
+
+    /// @brief 移除最大值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMax() {
+        if (m_size == 0) throw std::out_of_range("RunLengthHeap::popMax - no element");
+        return take(m_heap.peekMax(), false);
+    }
+
+    /// @brief 回傳最小值，不移除
+    /// @throw std::out_of_range - 如果為空
+    const value_type& peekMin() const { return m_heap.peekMin(); }
+
+    /// @brief 回傳最大值，不移除
+    /// @throw std::out_of_range - 如果為空
+    const value_type& peekMax() const { return m_heap.peekMax(); }
+
+    /// @brief value 有幾個
+    size_t count(const value_type& value) const {
+        auto it = m_count.find(value);
+        return it == m_count.end() ? 0 : it->second;
+    }
+
+    /// 有幾個元素（重複的值分開算）
+    size_t size() const { return m_size; }
+
+    /// 有幾種不同的值，也就是 heap 中的節點數
+    size_t distinct() const { return m_heap.size(); }
+
+private:
+    /// @brief 拿走一個 value，數量減到 0 時才從 heap 的最小端或最大端移除
+    value_type take(const value_type& value, bool min) {
+        auto it = m_count.find(value);
+        --m_size;
+
+        if (--it->second != 0) return value;
+
+        m_count.erase(it);
+        return min ? m_heap.popMin() : m_heap.popMax();
+    }
+};
+
+#endif // RUNLENGTHHEAP_H
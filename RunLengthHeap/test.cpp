@@ -0,0 +1,89 @@
+#include "RunLengthHeap.h"
+#include "Depq.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+static_assert(Depq_Trait::isDepq<RunLengthHeap<int>>, "RunLengthHeap should satisfy the DEPQ interface");
+
+TEST(RunLengthHeap, popTest) {
+    // 1, 3, 3, 6, 8, 9
+    RunLengthHeap<int> heap {9, 1, 6, 3, 3, 8};
+    ASSERT_TRUE(heap.size() == 6);
+    ASSERT_TRUE(heap.distinct() == 5);
+    ASSERT_TRUE(heap.count(3) == 2);
+
+    ASSERT_TRUE(heap.popMin() == 1);
+    ASSERT_TRUE(heap.popMin() == 3);
+    ASSERT_TRUE(heap.distinct() == 4);
+    ASSERT_TRUE(heap.popMin() == 3);
+    ASSERT_TRUE(heap.distinct() == 3);
+    ASSERT_TRUE(heap.popMax() == 9);
+    ASSERT_TRUE(heap.popMax() == 8);
+    ASSERT_TRUE(heap.popMax() == 6);
+
+    ASSERT_THROW(heap.popMin(), std::out_of_range);
+    ASSERT_THROW(heap.popMax(), std::out_of_range);
+    ASSERT_THROW(heap.peekMin(), std::out_of_range);
+}
+
+TEST(RunLengthHeap, pushCount) {
+    RunLengthHeap<int, BasicDeap> heap;
+    heap.push(5, 3);
+    heap.push(2, 0);
+    heap.push(7);
+
+    ASSERT_TRUE(heap.size() == 4);
+    ASSERT_TRUE(heap.distinct() == 2);
+    ASSERT_TRUE(heap.count(2) == 0);
+    ASSERT_TRUE(heap.peekMin() == 5);
+    ASSERT_TRUE(heap.popMax() == 7);
+    ASSERT_TRUE(heap.popMax() == 5);
+    ASSERT_TRUE(heap.size() == 2);
+}
+
+template<template<typename> class Heap>
+static void testRandom() {
+    RunLengthHeap<int, Heap> heap;
+    MinMaxHeap expected;
+
+    for (int i = 0; i < 1000; ++i) {
+        const int v = rand() % 10;
+        heap.push(v);
+        expected.push(v);
+        ASSERT_TRUE(heap.distinct() <= 10);
+    }
+
+    while (expected.size()) {
+        ASSERT_TRUE(heap.size() == expected.size());
+        ASSERT_TRUE(heap.peekMin() == expected.peekMin());
+        ASSERT_TRUE(heap.peekMax() == expected.peekMax());
+
+        if (rand() & 1) ASSERT_TRUE(heap.popMin() == expected.popMin());
+        else            ASSERT_TRUE(heap.popMax() == expected.popMax());
+
+        // 偶爾插入新的值
+        if (rand() % 4 == 0) {
+            const int v = rand() % 10;
+            heap.push(v);
+            expected.push(v);
+        }
+    }
+    ASSERT_TRUE(heap.size() == 0);
+    ASSERT_TRUE(heap.distinct() == 0);
+}
+
+TEST(RunLengthHeap, randomMinMaxHeap) {
+    unsigned seed = time(NULL);
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+    testRandom<BasicMinMaxHeap>();
+}
+
+TEST(RunLengthHeap, randomDeap) {
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+    testRandom<BasicDeap>();
+}
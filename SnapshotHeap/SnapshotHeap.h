@@ -0,0 +1,300 @@
+/**
+ * @file SnapshotHeap.h
+ * @brief 讓讀取的 thread 不需要搶 lock 就能查詢最小值、最大值，並取得整個 heap 唯讀快照的 double-ended priority queue
+ */
+#ifndef SNAPSHOTHEAP_H
+#define SNAPSHOTHEAP_H
+
+#include "MinMaxHeap.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 一個 writer、多個 reader 的 double-ended priority queue
+ * @tparam Heap - 存放值的 heap，需要可以複製，並提供 push、popMin、popMax、peekMin、peekMax、size，例如 MinMaxHeap 或 Deap
+ * @details
+ * # 最小值、最大值
+ * 每次修改後，writer 用 seqlock 發布目前的最小值、最大值和大小：先把 m_seq 改成奇數，寫入三個 atomic，再改回偶數。
+ * reader 讀到奇數或前後不一致就重讀，不會等待任何 lock。value_type 必須是 trivially copyable；
+ * 如果 `std::atomic<value_type>` 是 lock-free，reader 也是 lock-free。
+ *
+ * # 快照（copy-on-write）
+ * heap 存在 Version 中，m_current 指向目前的 Version。snapshot() 把目前的 Version 標成 SHARED，之後它就不會再被修改：
+ * - writer 修改前嘗試把 Version 的狀態從 0 改成 WRITING。成功就直接修改；失敗代表它已經被快照，
+ *   writer 會複製一份新的 Version、修改後發布到 m_current，舊的交給 epoch-based reclamation 回收。
+ * - 所以沒有人拿快照時，修改不需要複製；拿了快照後，下一次修改才複製一次。
+ * - snapshot() 遇到 writer 正在原地修改（WRITING）時，會等這一次修改結束（一次 push 或 pop 的時間）。
+ *
+ * # Epoch-based reclamation
+ * 每個快照佔用一個 reader slot，記錄進入時的 epoch。writer 把舊的 Version 連同當時的 epoch 放進 m_retired，並把 epoch 加 1；
+ * 只有當所有使用中的 slot 的 epoch 都比它大時，才不可能還有快照指向它，可以釋放。快照存在越久，舊的 Version 就越晚被釋放。
+ *
+ * 修改的函數（push、popMin、popMax）可以從多個 thread 呼叫，彼此用 mutex 排隊；其他函數可以在任何 thread 呼叫。
+ */
+template<typename Heap = MinMaxHeap>
+class SnapshotHeap {
+public:
+    typedef typename Heap::value_type value_type;
+    static_assert(std::is_trivially_copyable<value_type>::value, "SnapshotHeap - value_type must be trivially copyable");
+
+    /// 同一時間的最小值、最大值和大小。size 為 0 時 min、max 沒有意義
+    struct Extremes {
+        value_type min;
+        value_type max;
+        size_t size;
+    };
+
+private:
+    /// 常見的 cache line 大小
+    static constexpr size_t CACHE_LINE = 64;
+
+    /// Version::m_state 的 bit
+    static constexpr uint32_t WRITING = 1;  ///< writer 正在原地修改
+    static constexpr uint32_t SHARED = 2;   ///< 已經被快照，不能再修改
+
+    struct Version {
+        Heap m_heap;
+        std::atomic<uint32_t> m_state{ 0 };
+
+        Version() = default;
+        explicit Version(const Heap& heap) : m_heap(heap) {}
+    };
+
+    /// reader slot，0 代表沒有使用
+    struct Slot {
+        alignas(CACHE_LINE) std::atomic<uint64_t> m_epoch{ 0 };
+    };
+
+public:
+    /// @brief 唯讀的快照，存在期間 heap() 的內容不會改變
+    class Snapshot {
+        friend class SnapshotHeap;
+
+        Slot* m_slot;
+        const Version* m_version;
+
+        Snapshot(Slot* slot, const Version* version) : m_slot(slot), m_version(version) {}
+
+    public:
+        Snapshot(Snapshot&& other) noexcept : m_slot(other.m_slot), m_version(other.m_version) { other.m_slot = nullptr; }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        ~Snapshot() {
+            if (m_slot) m_slot->m_epoch.store(0, std::memory_order_release);
+        }
+
+        /// 快照的內容
+        const Heap& heap() const { return m_version->m_heap; }
+        const Heap* operator->() const { return &m_version->m_heap; }
+    };
+
+private:
+    // 發布給 reader 的最小值、最大值和大小
+    alignas(CACHE_LINE) std::atomic<uint64_t> m_seq{ 0 };
+    std::atomic<value_type> m_min{};
+    std::atomic<value_type> m_max{};
+    std::atomic<size_t> m_size{ 0 };
+
+    alignas(CACHE_LINE) std::atomic<Version*> m_current;
+    std::atomic<uint64_t> m_epoch{ 1 };
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_slotCount;
+
+    /// writer 之間的 mutex，reader 不會用到
+    std::mutex m_writeMutex;
+    /// 等待回收的 (Version, 被換掉時的 epoch)，只有 writer 會存取
+    std::vector<std::pair<Version*, uint64_t>> m_retired;
+
+public:
+    /// @brief 建立空的 SnapshotHeap
+    /// @param maxSnapshots - 同一時間最多有幾個快照
+    /// @throw std::invalid_argument - 如果 maxSnapshots 為 0
+    explicit SnapshotHeap(size_t maxSnapshots = 64)
+        : m_current(new Version()), m_slots(new Slot[maxSnapshots]), m_slotCount(maxSnapshots)
+    {
+        if (maxSnapshots == 0) {
+            delete m_current.load();
+            throw std::invalid_argument("SnapshotHeap - maxSnapshots must be positive");
+        }
+    }
+
+    /// @pre 所有快照都已經被釋放
+    ~SnapshotHeap() {
+        delete m_current.load();
+        for (auto& r : m_retired) delete r.first;
+    }
+
+    SnapshotHeap(const SnapshotHeap&) = delete;
+    SnapshotHeap& operator=(const SnapshotHeap&) = delete;
+
+    /// @brief 插入 value
+    void push(const value_type& value) {
+        modify([&](Heap& heap) { heap.push(value); });
+    }
+
+    /// @brief 移除最小值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMin() {
+        value_type ret;
+        modify([&](Heap& heap) { ret = heap.popMin(); });
+        return ret;
+    }
+
+    /// @brief 移除最大值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMax() {
+        value_type ret;
+        modify([&](Heap& heap) { ret = heap.popMax(); });
+        return ret;
+    }
+
+    /// @brief 讀取最近一次修改後的最小值、最大值和大小，不會等待 writer
+    Extremes extremes() const {
+        Extremes e;
+        uint64_t before, after;
+        do {
+            before = m_seq.load(std::memory_order_acquire);
+            e.min  = m_min.load(std::memory_order_relaxed);
+            e.max  = m_max.load(std::memory_order_relaxed);
+            e.size = m_size.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_seq.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return e;
+    }
+
+    /// @brief 回傳最小值，不會等待 writer
+    /// @throw std::out_of_range - 如果為空
+    value_type peekMin() const {
+        const Extremes e = extremes();
+        if (e.size == 0) throw std::out_of_range("SnapshotHeap::peekMin - no element");
+        return e.min;
+    }
+
+    /// @brief 回傳最大值，不會等待 writer
+    /// @throw std::out_of_range - 如果為空
+    value_type peekMax() const {
+        const Extremes e = extremes();
+        if (e.size == 0) throw std::out_of_range("SnapshotHeap::peekMax - no element");
+        return e.max;
+    }
+
+    /// 有幾個元素，不會等待 writer
+    size_t size() const { return m_size.load(std::memory_order_acquire); }
+
+    /// @brief 取得目前整個 heap 的唯讀快照
+    /// @throw std::length_error - 如果同時存在的快照超過 maxSnapshots
+    Snapshot snapshot() {
+        Slot* slot = enter();
+
+        // enter() 之後才讀 m_current，所以 writer 在這之後換掉的 Version 不會被釋放
+        Version* version = m_current.load(std::memory_order_seq_cst);
+
+        uint32_t state = version->m_state.load(std::memory_order_acquire);
+        while (!(state & SHARED)) {
+            if (state & WRITING) {
+                std::this_thread::yield();
+                state = version->m_state.load(std::memory_order_acquire);
+            }
+            else if (version->m_state.compare_exchange_weak(state, SHARED, std::memory_order_acq_rel)) {
+                break;
+            }
+        }
+
+        return Snapshot(slot, version);
+    }
+
+    /// 已經被換掉、還在等待回收的 Version 有幾個
+    size_t pendingReclaim() {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        return m_retired.size();
+    }
+
+private:
+    /// @brief 找一個空的 slot，記錄目前的 epoch
+    Slot* enter() {
+        for (size_t i = 0; i < m_slotCount; ++i) {
+            uint64_t expected = 0;
+            if (m_slots[i].m_epoch.compare_exchange_strong(expected, m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst))
+                return &m_slots[i];
+        }
+        throw std::length_error("SnapshotHeap::snapshot - too many snapshots");
+    }
+
+    /// @brief 修改 heap：沒有被快照就原地修改，否則複製一份新的 Version
+    /// @tparam Func - 接受 `Heap&` 的 callable
+    template<typename Func>
+    void modify(Func func) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        Version* version = m_current.load(std::memory_order_relaxed);
+
+        uint32_t expected = 0;
+        if (version->m_state.compare_exchange_strong(expected, WRITING, std::memory_order_acq_rel)) {
+            try {
+                func(version->m_heap);
+            }
+            catch (...) {
+                version->m_state.store(0, std::memory_order_release);
+                throw;
+            }
+            publish(version->m_heap);
+            version->m_state.store(0, std::memory_order_release);
+            return;
+        }
+
+        // 已經被快照：複製一份新的，修改後再發布，reader 看不到修改到一半的 Version
+        std::unique_ptr<Version> copy(new Version(version->m_heap));
+        func(copy->m_heap);
+        publish(copy->m_heap);
+        m_current.store(copy.release(), std::memory_order_seq_cst);
+        retire(version);
+    }
+
+    /// @brief 發布最小值、最大值和大小
+    void publish(const Heap& heap) {
+        const uint64_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const size_t n = heap.size();
+        if (n != 0) {
+            m_min.store(heap.peekMin(), std::memory_order_relaxed);
+            m_max.store(heap.peekMax(), std::memory_order_relaxed);
+        }
+        m_size.store(n, std::memory_order_relaxed);
+
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /// @brief 把被換掉的 version 放進等待回收的清單，並釋放已經沒有快照會用到的 Version
+    void retire(Version* version) {
+        m_retired.emplace_back(version, m_epoch.fetch_add(1, std::memory_order_seq_cst));
+
+        // 使用中的 slot 中最小的 epoch
+        uint64_t oldest = UINT64_MAX;
+        for (size_t i = 0; i < m_slotCount; ++i) {
+            const uint64_t e = m_slots[i].m_epoch.load(std::memory_order_seq_cst);
+            if (e != 0 && e < oldest) oldest = e;
+        }
+
+        // 在 epoch r 被換掉的 Version，只可能被 epoch <= r 的快照拿到
+        size_t kept = 0;
+        for (auto& r : m_retired) {
+            if (r.second < oldest) delete r.first;
+            else                   m_retired[kept++] = r;
+        }
+        m_retired.resize(kept);
+    }
+};
+
+#endif // SNAPSHOTHEAP_H
@@ -0,0 +1,117 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 SnapshotHeap 和「用 mutex 保護的 MinMaxHeap」在一個 writer、多個 reader 下的吞吐量
+ * @note 結果受 CPU 核心數影響很大，核心數少於 thread 數時，數字主要反映排程而不是同步的成本
+ */
+#include "SnapshotHeap.h"
+#include "MinMaxHeap.h"
+#include "Benchmark.h"
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const size_t WRITES = 1 << 20;  ///< writer 總共修改幾次
+static const size_t PREFILL = 1 << 14;
+
+/// 用 mutex 保護的 MinMaxHeap，reader 讀取時也要 lock
+class LockedHeap {
+    std::mutex m_mutex;
+    MinMaxHeap m_heap;
+
+public:
+    void push(int v) { std::lock_guard<std::mutex> lock(m_mutex); m_heap.push(v); }
+    int popMin() { std::lock_guard<std::mutex> lock(m_mutex); return m_heap.popMin(); }
+    int popMax() { std::lock_guard<std::mutex> lock(m_mutex); return m_heap.popMax(); }
+
+    int peekSum() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_heap.peekMin() + m_heap.peekMax();
+    }
+
+    /// 完整掃描時只能複製整個 heap
+    size_t scan() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        MinMaxHeap copy = m_heap;
+        return copy.size();
+    }
+};
+
+/// SnapshotHeap 的 reader 介面和 LockedHeap 一樣
+class SnapshotAdapter {
+    SnapshotHeap<> m_heap;
+
+public:
+    void push(int v) { m_heap.push(v); }
+    int popMin() { return m_heap.popMin(); }
+    int popMax() { return m_heap.popMax(); }
+
+    int peekSum() {
+        auto e = m_heap.extremes();
+        return e.min + e.max;
+    }
+
+    size_t scan() { return m_heap.snapshot()->size(); }
+};
+
+/**
+ * @brief writer 交錯 push、pop WRITES 次；readers 個 reader 在 writer 結束前不停讀取最小值和最大值，
+ *        每讀 scanEvery 次做一次完整掃描（0 代表不掃描）
+ */
+template<typename Heap>
+static void run(const std::string& name, size_t readers, size_t scanEvery)
+{
+    Heap heap;
+    std::mt19937 gen(12345);
+    for (size_t i = 0; i < PREFILL; ++i) heap.push(int(gen() % 1000000));
+
+    std::atomic<bool> start{ false }, done{ false };
+    std::atomic<size_t> reads{ 0 };
+    std::vector<std::thread> threads;
+
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&] {
+            while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+
+            size_t count = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                Benchmark::keep(heap.peekSum());
+                if (scanEvery != 0 && count % scanEvery == 0) Benchmark::keep(heap.scan());
+                ++count;
+            }
+            reads.fetch_add(count);
+        });
+    }
+
+    Benchmark::Timer timer;
+    start.store(true, std::memory_order_release);
+    for (size_t i = 0; i < WRITES; ++i) {
+        // push 和 pop 交錯，大小維持在 PREFILL 附近
+        if (i & 1) heap.push(int(gen() % 1000000));
+        else       Benchmark::keep((i & 2) ? heap.popMin() : heap.popMax());
+    }
+    const double seconds = timer.seconds();
+    done.store(true);
+    for (auto& t : threads) t.join();
+
+    const std::string label = name + " r=" + std::to_string(readers) + (scanEvery ? " +scan" : "");
+    Benchmark::report((label + " writer").c_str(), WRITES, seconds);
+    if (readers != 0) Benchmark::report((label + " reader").c_str(), reads.load(), seconds * readers);
+}
+
+int main()
+{
+    for (size_t readers : {0, 1, 2, 4, 8}) {
+        printf("== %zu readers ==\n", readers);
+        run<LockedHeap>("mutex", readers, 0);
+        run<SnapshotAdapter>("SnapshotHeap", readers, 0);
+    }
+
+    printf("== 2 readers, full scan every 4096 reads ==\n");
+    run<LockedHeap>("mutex", 2, 4096);
+    run<SnapshotAdapter>("SnapshotHeap", 2, 4096);
+
+    return 0;
+}
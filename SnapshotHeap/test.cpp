@@ -0,0 +1,115 @@
+#include "SnapshotHeap.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(SnapshotHeap, extremes) {
+    SnapshotHeap<Deap> heap;
+    ASSERT_THROW(SnapshotHeap<>(0), std::invalid_argument);
+    ASSERT_TRUE(heap.size() == 0);
+    ASSERT_THROW(heap.peekMin(), std::out_of_range);
+    ASSERT_THROW(heap.popMax(), std::out_of_range);
+
+    for (int v : {5, 1, 9, 3, 7}) heap.push(v);
+    auto e = heap.extremes();
+    ASSERT_TRUE(e.min == 1 && e.max == 9 && e.size == 5);
+
+    ASSERT_TRUE(heap.popMin() == 1);
+    ASSERT_TRUE(heap.popMax() == 9);
+    ASSERT_TRUE(heap.peekMin() == 3);
+    ASSERT_TRUE(heap.peekMax() == 7);
+    ASSERT_TRUE(heap.size() == 3);
+}
+
+TEST(SnapshotHeap, snapshot) {
+    SnapshotHeap<> heap(2);
+    for (int v : {4, 2, 6}) heap.push(v);
+
+    {
+        auto s1 = heap.snapshot();
+        heap.push(10);
+        ASSERT_TRUE(heap.popMin() == 2);
+
+        // 快照的內容不受之後的修改影響
+        ASSERT_TRUE(s1->size() == 3);
+        ASSERT_TRUE(s1->peekMin() == 2 && s1->peekMax() == 6);
+
+        auto s2 = heap.snapshot();
+        ASSERT_THROW(heap.snapshot(), std::length_error);
+        heap.push(0);
+        ASSERT_TRUE(s2->size() == 3);
+        ASSERT_TRUE(s2->peekMin() == 4 && s2->peekMax() == 10);
+
+        // s1、s2 還在，被換掉的 Version 不能釋放
+        ASSERT_TRUE(heap.pendingReclaim() == 2);
+    }
+
+    // 快照都釋放後，下一次換掉 Version 時一起回收
+    auto s3 = heap.snapshot();
+    heap.push(1);
+    ASSERT_TRUE(heap.pendingReclaim() == 1);
+    ASSERT_TRUE(s3->size() == 4);
+    ASSERT_TRUE(heap.size() == 5);
+}
+
+TEST(SnapshotHeap, noCopyWithoutSnapshot) {
+    SnapshotHeap<> heap;
+    for (int i = 0; i < 1000; ++i) heap.push(i);
+    ASSERT_TRUE(heap.pendingReclaim() == 0);
+
+    // 同一個快照之後只會複製一次
+    auto s = heap.snapshot();
+    for (int i = 0; i < 1000; ++i) heap.popMax();
+    ASSERT_TRUE(heap.pendingReclaim() == 1);
+    ASSERT_TRUE(s->size() == 1000 && heap.size() == 0);
+}
+
+TEST(SnapshotHeap, multiThread) {
+    const int n = 50000;
+    SnapshotHeap<> heap(8);
+    std::atomic<bool> done{ false };
+
+    // writer 只 push 遞增的值，偶爾 popMin；所以 reader 看到的 max 不會變小，而且 min <= max
+    std::thread writer([&] {
+        for (int i = 0; i < n; ++i) {
+            heap.push(i);
+            if (i % 3 == 0) heap.popMin();
+        }
+        done.store(true);
+    });
+
+    std::vector<std::thread> readers;
+    std::atomic<int> errors{ 0 };
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&, r] {
+            int lastMax = -1;
+            size_t scans = 0;
+            while (!done.load()) {
+                auto e = heap.extremes();
+                if (e.size != 0) {
+                    if (e.min > e.max || e.max < lastMax) ++errors;
+                    lastMax = e.max;
+                }
+
+                // 偶爾做一次完整的掃描：快照必須是合法而且不會改變的 heap
+                if (r == 0 && ++scans % 64 == 0) {
+                    auto s = heap.snapshot();
+                    if (s->size() != 0) {
+                        const int lo = s->peekMin(), hi = s->peekMax();
+                        std::this_thread::yield();
+                        if (s->peekMin() != lo || s->peekMax() != hi || lo > hi) ++errors;
+                    }
+                }
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& t : readers) t.join();
+    ASSERT_TRUE(errors.load() == 0);
+    ASSERT_TRUE(heap.size() == size_t(n - (n + 2) / 3));
+    ASSERT_TRUE(heap.peekMax() == n - 1);
+}
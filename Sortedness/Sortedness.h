@@ -0,0 +1,100 @@
+/**
+ * @file Sortedness.h
+ * @brief MinMaxHeap 和 Deap 建構時共用的工具：判斷輸入的排序程度，以及把排序好的輸入原地擺成 heap
+ */
+#ifndef SORTEDNESS_H
+#define SORTEDNESS_H
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// MinMaxHeap 和 Deap 建構時共用的函數
+namespace Sortedness_Trait {
+    /// 遞增的 run 不超過這個數量時，先合併成排序好的陣列再直接擺放，比 heapify 少比較
+    constexpr size_t MAX_RUNS = 4;
+
+    /// @brief 輸入的排序程度
+    struct Sortedness {
+        size_t descents = 0;         ///< `v[i] < v[i - 1]` 的次數，為 0 代表遞增
+        bool hasAscent = false;      ///< 是否有 `v[i] > v[i - 1]`，沒有代表遞減
+        size_t runStarts[MAX_RUNS];  ///< 前 MAX_RUNS 個 descent 的位置，也就是第 2 個之後的遞增 run 的起點
+    };
+
+    /// @brief 掃描 v 計算排序程度
+    /// @details descent 超過 MAX_RUNS 而且已經有 ascent 時提早結束，所以亂序的輸入只會多比較幾次
+    /// @tparam Container - 可以用 index 存取的容器，元素需要支援 `<`、`>`
+    template<typename Container>
+    Sortedness sortedness(const Container& v) {
+        Sortedness s;
+        for (size_t i = 1; i < v.size(); ++i) {
+            if (v[i] < v[i - 1]) {
+                if (s.descents < MAX_RUNS) s.runStarts[s.descents] = i;
+                ++s.descents;
+            }
+            // 遞增的輸入只需要比較一次；已經知道有 ascent 之後就不用再比了
+            else if (!s.hasAscent && v[i] > v[i - 1]) s.hasAscent = true;
+
+            if (s.descents >= MAX_RUNS && s.hasAscent) break;
+        }
+        return s;
+    }
+
+    /// @brief 把 v 中不超過 MAX_RUNS 個遞增的 run 合併成遞增的陣列
+    /// @pre s 是 sortedness(v) 的結果，而且 0 < s.descents < MAX_RUNS
+    template<typename Container>
+    void mergeRuns(Container& v, const Sortedness& s) {
+        for (size_t r = 0; r < s.descents; ++r) {
+            const size_t end = r + 1 < s.descents ? s.runStarts[r + 1] : v.size();
+            std::inplace_merge(v.begin(), v.begin() + s.runStarts[r], v.begin() + end);
+        }
+    }
+
+    /// @brief 最高位的 1 是第幾個 bit（從 0 開始）
+    /// @pre x != 0
+    inline size_t floorLog2(uint64_t x) {
+#if defined(_MSC_VER)
+        unsigned long id;
+        _BitScanReverse64(&id, x);
+        return id;
+#else
+        return 63 - static_cast<size_t>(__builtin_clzll(x));
+#endif
+    }
+
+    /**
+     * @brief 原地重新排列 v，讓新的 `v[i]` 為原本的 `v[source(i)]`
+     * @details 沿著排列的 cycle 搬移，每個元素只搬一次；除了一個暫存的元素之外，只需要 n 個 bit 記錄搬過的位置
+     * @param source - 排列，`size_t(size_t)`，必須是 0 ~ n-1 的一對一對應
+     */
+    template<typename Container, typename Source>
+    void permute(Container& v, Source source) {
+        typedef typename std::decay<decltype(v[0])>::type value_type;
+
+        std::vector<bool> done(v.size());
+        for (size_t start = 0; start < v.size(); ++start) {
+            if (done[start]) continue;
+
+            value_type first = std::move(v[start]);
+            size_t i = start;
+            while (true) {
+                done[i] = true;
+                const size_t from = source(i);
+                if (from == start) break;
+
+                v[i] = std::move(v[from]);
+                i = from;
+            }
+            v[i] = std::move(first);
+        }
+    }
+}
+
+#endif // SORTEDNESS_H
@@ -0,0 +1,154 @@
+/**
+ * @file StableHeap.h
+ * @brief 值相同時依加入順序取出的 double-ended priority queue，插入順序被壓進整數 key 的低位，比較只需要一次整數比較
+ */
+#ifndef STABLEHEAP_H
+#define STABLEHEAP_H
+
+#include "MinMaxHeap.h"
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/// key 相同時，popMax 取出的順序
+enum class TieOrder {
+    Lifo,  ///< popMax 先取出最晚加入的；popMin 先取出最早加入的
+    Fifo,  ///< popMax 先取出最早加入的；popMin 先取出最晚加入的
+};
+
+/**
+ * @brief key 相同時依加入順序取出的 double-ended priority queue
+ * @tparam Key - key 的型別，必須是整數
+ * @tparam Value - 和 key 一起存放的值，不參與比較
+ * @tparam MaxTies - key 相同時 popMax 的順序
+ * @tparam Packed - 壓縮後的 key，必須是無號整數（例如 uint64_t，或編譯器支援時的 unsigned __int128），位元數要比 Key 多至少 8
+ * @tparam Heap - 存放元素的 heap 樣板，例如 BasicMinMaxHeap 或 BasicDeap
+ * @details
+ * # 壓縮的 key
+ * Packed 的高位放 key（有號整數先把 sign bit 反轉，讓無號整數的大小順序和原本一樣），低位放插入序號。
+ * 所以比較兩個元素只需要比較一次 Packed，不需要先比 key、再比序號。
+ *
+ * # 順序
+ * 同一個順序中，同 key 的元素只能有一端是「先進先出」：
+ * - TieOrder::Lifo：低位為序號，同 key 時序號小的比較小，popMin 為 FIFO、popMax 為 LIFO
+ * - TieOrder::Fifo：低位為「最大序號 - 序號」，popMax 為 FIFO、popMin 為 LIFO
+ *
+ * # 序號用完
+ * 低位只有 `SEQ_BITS` 個 bit。序號用完時，把所有元素依目前的順序取出，重新編號成 0 ~ n-1（同 key 的先後順序不變），
+ * 再用排序好的結果重建 heap。每 2^SEQ_BITS 次 push 才會發生一次，攤銷後可以忽略。
+ */
+template<typename Key, typename Value, TieOrder MaxTies = TieOrder::Lifo, typename Packed = uint64_t,
+         template<typename> class Heap = BasicMinMaxHeap>
+class StableHeap {
+    static_assert(std::is_integral<Key>::value && !std::is_same<Key, bool>::value, "StableHeap - Key must be an integral type");
+    static_assert(Packed(0) < Packed(-1), "StableHeap - Packed must be an unsigned integer");
+
+public:
+    typedef Key key_type;
+    typedef Value mapped_type;
+    typedef std::pair<Key, Value> value_type;
+
+    /// key 佔幾個 bit
+    static constexpr size_t KEY_BITS = sizeof(Key) * 8;
+    /// 序號佔幾個 bit
+    static constexpr size_t SEQ_BITS = sizeof(Packed) * 8 - KEY_BITS;
+    static_assert(sizeof(Packed) * 8 >= KEY_BITS + 8, "StableHeap - Packed must have at least 8 more bits than Key");
+
+private:
+    typedef typename std::make_unsigned<Key>::type UKey;
+
+    /// 序號的上限（不包含）
+    static constexpr Packed SEQ_LIMIT = Packed(1) << SEQ_BITS;
+    /// 有號的 key 要反轉的 bit
+    static constexpr UKey SIGN_FLIP = std::is_signed<Key>::value ? UKey(UKey(1) << (KEY_BITS - 1)) : UKey(0);
+
+    /// heap 中的元素，只比較 m_key
+    struct Entry {
+        Packed m_key;
+        Value m_value;
+
+        friend bool operator< (const Entry& a, const Entry& b) { return a.m_key <  b.m_key; }
+        friend bool operator> (const Entry& a, const Entry& b) { return a.m_key >  b.m_key; }
+        friend bool operator<=(const Entry& a, const Entry& b) { return a.m_key <= b.m_key; }
+        friend bool operator>=(const Entry& a, const Entry& b) { return a.m_key >= b.m_key; }
+        friend bool operator==(const Entry& a, const Entry& b) { return a.m_key == b.m_key; }
+    };
+
+    Heap<Entry> m_heap;
+    /// 下一個序號
+    Packed m_next = 0;
+
+public:
+    StableHeap() = default;
+
+    /// @brief 插入 key 和 value
+    /// @throw std::length_error - 如果元素的數量達到 2^SEQ_BITS
+    void push(Key key, Value value) {
+        if (m_next == SEQ_LIMIT) renumber();
+        m_heap.push(Entry{ pack(key, m_next++), std::move(value) });
+    }
+
+    /// @brief 移除 key 最小的元素並回傳；key 相同時的順序見 TieOrder
+    /// @throw std::out_of_range - 如果為空
+    value_type popMin() { return unpack(m_heap.popMin()); }
+
+    /// @brief 移除 key 最大的元素並回傳；key 相同時的順序見 TieOrder
+    /// @throw std::out_of_range - 如果為空
+    value_type popMax() { return unpack(m_heap.popMax()); }
+
+    /// @brief 回傳 popMin() 會取出的元素，不移除
+    /// @throw std::out_of_range - 如果為空
+    value_type peekMin() const { return unpack(m_heap.peekMin()); }
+
+    /// @brief 回傳 popMax() 會取出的元素，不移除
+    /// @throw std::out_of_range - 如果為空
+    value_type peekMax() const { return unpack(m_heap.peekMax()); }
+
+    /// 有幾個元素
+    size_t size() const { return m_heap.size(); }
+
+private:
+    /// @brief 把 key 和序號壓成一個整數
+    static Packed pack(Key key, Packed seq) {
+        const Packed low = MaxTies == TieOrder::Lifo ? seq : SEQ_LIMIT - 1 - seq;
+        return (Packed(UKey(UKey(key) ^ SIGN_FLIP)) << SEQ_BITS) | low;
+    }
+
+    /// @brief 從壓縮的 key 取回原本的 key
+    static Key keyOf(Packed packed) {
+        return static_cast<Key>(UKey(UKey(packed >> SEQ_BITS) ^ SIGN_FLIP));
+    }
+
+    static value_type unpack(Entry e) { return value_type(keyOf(e.m_key), std::move(e.m_value)); }
+
+    /**
+     * @brief 序號用完時，把所有元素重新編號成 0 ~ n-1
+     * @details
+     * 依 Packed 由小到大取出後：
+     * - TieOrder::Lifo 時同 key 的序號是遞增的，新的序號為排名
+     * - TieOrder::Fifo 時同 key 的序號是遞減的，新的序號為 n - 1 - 排名
+     * 兩種都保留同 key 的先後順序。全部取出是 O(n log n)，用範圍建構子重建是 O(n)。
+     * 重新編號後，要再 push 2^SEQ_BITS - n 次才會再重新編號，所以攤銷到每次 push 的成本很小。
+     */
+    void renumber() {
+        const size_t n = m_heap.size();
+        if (Packed(n) >= SEQ_LIMIT) throw std::length_error("StableHeap::push - too many elements");
+
+        std::vector<Entry> entries;
+        entries.reserve(n);
+        while (m_heap.size() != 0) entries.push_back(m_heap.popMin());
+
+        for (size_t rank = 0; rank < n; ++rank) {
+            const Packed seq = MaxTies == TieOrder::Lifo ? Packed(rank) : Packed(n - 1 - rank);
+            entries[rank].m_key = pack(keyOf(entries[rank].m_key), seq);
+        }
+
+        m_heap = Heap<Entry>(entries.begin(), entries.end());
+        m_next = Packed(n);
+    }
+};
+
+#endif // STABLEHEAP_H
@@ -0,0 +1,72 @@
+/**
+ * @file bench.cpp
+ * @brief 比較 StableHeap（序號壓進 key 的低位）和「heap 中存 (key, 序號) 兩個欄位、逐欄比較」的速度
+ */
+#include "StableHeap.h"
+#include "MinMaxHeap.h"
+#include "Benchmark.h"
+#include <random>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+static const size_t N = 1 << 15;      ///< heap 維持的大小
+static const size_t OPS = 1 << 22;   ///< push + pop 的次數
+static const int KEYS = 16;           ///< key 的種類，越少越常相同
+
+/// 另外存放序號的做法：比較時先比 key，相同再比序號
+class PairHeap {
+    struct Entry {
+        int m_key;
+        uint64_t m_seq;
+        int m_value;
+
+        friend bool operator< (const Entry& a, const Entry& b) { return a.m_key != b.m_key ? a.m_key < b.m_key : a.m_seq < b.m_seq; }
+        friend bool operator> (const Entry& a, const Entry& b) { return b < a; }
+        friend bool operator<=(const Entry& a, const Entry& b) { return !(b < a); }
+        friend bool operator>=(const Entry& a, const Entry& b) { return !(a < b); }
+        friend bool operator==(const Entry& a, const Entry& b) { return a.m_key == b.m_key && a.m_seq == b.m_seq; }
+    };
+
+    BasicMinMaxHeap<Entry> m_heap;
+    uint64_t m_next = 0;
+
+public:
+    void push(int key, int value) { m_heap.push(Entry{ key, m_next++, value }); }
+    std::pair<int, int> popMin() { Entry e = m_heap.popMin(); return { e.m_key, e.m_value }; }
+    std::pair<int, int> popMax() { Entry e = m_heap.popMax(); return { e.m_key, e.m_value }; }
+};
+
+/**
+ * @brief 先放 N 個元素，再交錯 push、popMin、push、popMax 共 OPS 次
+ */
+template<typename Heap>
+void run(const char* name) {
+    std::mt19937 rng(1);
+    std::vector<int> keys(OPS);
+    for (int& k : keys) k = rng() % KEYS;
+
+    Heap heap;
+    for (size_t i = 0; i < N; ++i) heap.push(keys[i], int(i));
+
+    int sum = 0;
+    double seconds = Benchmark::measure([&] {
+        for (size_t i = 0; i < OPS; i += 4) {
+            heap.push(keys[i], int(i));
+            sum += heap.popMin().second;
+            heap.push(keys[i + 1], int(i + 1));
+            sum += heap.popMax().second;
+        }
+    });
+    Benchmark::keep(sum);
+    Benchmark::report(name, OPS / 2, seconds);
+}
+
+int main() {
+    printf("n = %zu, %d distinct keys, push + pop\n", N, KEYS);
+    run<PairHeap>("MinMaxHeap<(key, seq)>");
+    run<StableHeap<int, int>>("StableHeap<int, int> (packed uint64_t)");
+    run<StableHeap<int, int, TieOrder::Fifo>>("StableHeap<int, int, Fifo> (packed uint64_t)");
+    run<StableHeap<int16_t, int, TieOrder::Lifo, uint32_t>>("StableHeap<int16_t, int> (packed uint32_t, renumbers)");
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "StableHeap.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "gtest/gtest.h"
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <stdint.h>
+
+TEST(StableHeap, tieOrder) {
+    StableHeap<int, std::string> lifo;
+    ASSERT_THROW(lifo.popMin(), std::out_of_range);
+    ASSERT_THROW(lifo.peekMax(), std::out_of_range);
+
+    for (const char* s : {"a", "b", "c", "d"}) lifo.push(5, s);
+    lifo.push(-3, "low");
+    lifo.push(9, "high");
+    ASSERT_TRUE(lifo.size() == 6);
+    ASSERT_TRUE(lifo.peekMin() == std::make_pair(-3, std::string("low")));
+    ASSERT_TRUE(lifo.popMax() == std::make_pair(9, std::string("high")));
+    ASSERT_TRUE(lifo.popMin() == std::make_pair(-3, std::string("low")));
+
+    // popMin 為 FIFO，popMax 為 LIFO
+    ASSERT_TRUE(lifo.popMin().second == "a");
+    ASSERT_TRUE(lifo.popMax().second == "d");
+    ASSERT_TRUE(lifo.popMin().second == "b");
+    ASSERT_TRUE(lifo.popMax().second == "c");
+    ASSERT_TRUE(lifo.size() == 0);
+
+    // popMax 為 FIFO，popMin 為 LIFO
+    StableHeap<int, std::string, TieOrder::Fifo, uint64_t, BasicDeap> fifo;
+    for (const char* s : {"a", "b", "c", "d"}) fifo.push(5, s);
+    ASSERT_TRUE(fifo.popMax().second == "a");
+    ASSERT_TRUE(fifo.popMin().second == "d");
+    ASSERT_TRUE(fifo.popMax().second == "b");
+    ASSERT_TRUE(fifo.popMin().second == "c");
+}
+
+TEST(StableHeap, extremeKeys) {
+    StableHeap<int32_t, int> heap;
+    heap.push(INT32_MAX, 1);
+    heap.push(INT32_MIN, 2);
+    heap.push(0, 3);
+    heap.push(-1, 4);
+    ASSERT_TRUE(heap.popMin() == std::make_pair(INT32_MIN, 2));
+    ASSERT_TRUE(heap.popMin() == std::make_pair(-1, 4));
+    ASSERT_TRUE(heap.popMax() == std::make_pair(INT32_MAX, 1));
+    ASSERT_TRUE(heap.popMax() == std::make_pair(0, 3));
+
+#if defined(__SIZEOF_INT128__)
+    StableHeap<int64_t, int, TieOrder::Lifo, unsigned __int128> wide;
+    wide.push(INT64_MAX, 1);
+    wide.push(INT64_MIN, 2);
+    wide.push(INT64_MIN, 3);
+    ASSERT_TRUE(wide.popMin() == std::make_pair(INT64_MIN, 2));
+    ASSERT_TRUE(wide.popMax() == std::make_pair(INT64_MAX, 1));
+    ASSERT_TRUE(wide.popMax() == std::make_pair(INT64_MIN, 3));
+#endif
+}
+
+/// 用 (key, 插入順序) 排序的 set 當作答案，隨機操作足夠多次，讓只有 8 bit 的序號重新編號很多次
+template<TieOrder MaxTies, template<typename> class Heap>
+void renumberTest() {
+    StableHeap<uint8_t, int, MaxTies, uint16_t, Heap> heap;
+    std::set<std::tuple<int, int, int>> expected;  // (key, 插入順序, value)
+
+    std::mt19937 rng(7);
+    int order = 0;
+    for (int i = 0; i < 20000; ++i) {
+        const int op = rng() % 3;
+        if (op == 0 || expected.empty()) {
+            const uint8_t key = rng() % 4;
+            heap.push(key, i);
+            expected.emplace(key, order++, i);
+            continue;
+        }
+
+        std::set<std::tuple<int, int, int>>::iterator it;
+        std::pair<uint8_t, int> got;
+        if (op == 1) {
+            got = heap.popMin();
+            // 最小的 key 中，Lifo 取最早的，Fifo 取最晚的
+            it = MaxTies == TieOrder::Lifo ? expected.begin()
+                                           : std::prev(expected.lower_bound(std::make_tuple(std::get<0>(*expected.begin()) + 1, -1, -1)));
+        }
+        else {
+            got = heap.popMax();
+            // 最大的 key 中，Lifo 取最晚的，Fifo 取最早的
+            it = MaxTies == TieOrder::Lifo ? std::prev(expected.end())
+                                           : expected.lower_bound(std::make_tuple(std::get<0>(*expected.rbegin()), -1, -1));
+        }
+        ASSERT_TRUE(got.first == std::get<0>(*it) && got.second == std::get<2>(*it));
+        expected.erase(it);
+        ASSERT_TRUE(heap.size() == expected.size());
+    }
+}
+
+TEST(StableHeap, renumber) {
+    renumberTest<TieOrder::Lifo, BasicMinMaxHeap>();
+    renumberTest<TieOrder::Fifo, BasicMinMaxHeap>();
+    renumberTest<TieOrder::Lifo, BasicDeap>();
+    renumberTest<TieOrder::Fifo, BasicDeap>();
+
+    // 8 bit 的序號最多只能同時存放 255 個元素
+    StableHeap<uint8_t, int, TieOrder::Lifo, uint16_t> full;
+    for (int i = 0; i < 256; ++i) full.push(1, i);
+    ASSERT_THROW(full.push(1, 256), std::length_error);
+}
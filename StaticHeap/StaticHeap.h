@@ -0,0 +1,241 @@
+/**
+ * @file StaticHeap.h
+ * @brief 容量固定、元素直接存在物件內的 Min-Max Heap 和 Deap，不需要配置記憶體
+ */
+#ifndef STATICHEAP_H
+#define STATICHEAP_H
+
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <assert.h>
+#include <stddef.h>
+
+/**
+ * @brief 容量固定為 N 的 vector，元素存在物件內的 std::array
+ * @tparam T - 元素的型別，需要有 default constructor
+ * @tparam N - 容量
+ * @details 只提供 GenericMinMaxHeap、GenericDeap 用到的介面。超過容量時丟出 std::length_error。
+ * 被移除的位置會被設回 `T()`，讓 std::string 之類的型別釋放資源。
+ */
+template<typename T, size_t N>
+class StaticVector {
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+private:
+    std::array<T, N> m_data;
+    size_t m_size = 0;
+
+public:
+    StaticVector() = default;
+
+    /// @brief 從 [first, last) 建立
+    /// @throw std::length_error - 如果超過容量
+    template<typename InputIt>
+    StaticVector(InputIt first, InputIt last) { insert(end(), first, last); }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    T& operator[](size_t id) { return m_data[id]; }
+    const T& operator[](size_t id) const { return m_data[id]; }
+
+    T& front() { return m_data[0]; }
+    const T& front() const { return m_data[0]; }
+    T& back() { return m_data[m_size - 1]; }
+    const T& back() const { return m_data[m_size - 1]; }
+
+    iterator begin() { return m_data.data(); }
+    iterator end() { return m_data.data() + m_size; }
+    const_iterator begin() const { return m_data.data(); }
+    const_iterator end() const { return m_data.data() + m_size; }
+
+    /// @throw std::length_error - 如果已經滿了
+    void push_back(const T& value) {
+        if (m_size == N) throw std::length_error("StaticVector::push_back - capacity exceeded");
+        m_data[m_size++] = value;
+    }
+
+    /// @throw std::length_error - 如果已經滿了
+    void push_back(T&& value) {
+        if (m_size == N) throw std::length_error("StaticVector::push_back - capacity exceeded");
+        m_data[m_size++] = std::move(value);
+    }
+
+    void pop_back() {
+        assert(m_size != 0);
+        m_data[--m_size] = T();
+    }
+
+    void clear() {
+        while (m_size != 0) pop_back();
+    }
+
+    /// @brief 把 [first, last) 加到尾端，只支援 pos == end()
+    /// @throw std::length_error - 如果超過容量
+    template<typename InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        assert(pos == end());
+        (void)pos;
+
+        const size_t start = m_size;
+        for (; first != last; ++first) push_back(*first);
+        return begin() + start;
+    }
+
+    /// @throw std::length_error - 如果 n 超過容量
+    void reserve(size_t n) {
+        if (n > N) throw std::length_error("StaticVector::reserve - capacity exceeded");
+    }
+
+    void swap(StaticVector& other) {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+    }
+};
+
+/**
+ * @brief 元素很少時使用的 double-ended priority queue，元素依序排在物件內的陣列
+ * @tparam T - 元素的型別，需要支援 `<`，而且要有 default constructor
+ * @tparam N - 容量
+ * @details
+ * 元素少的時候，heap 的比較和分支反而比直接搬移還慢。這裡讓陣列保持遞增：
+ * - push：數出有幾個元素 `<=` 新的值（整個掃過、沒有提早結束，所以沒有難以預測的分支，int 之類的型別可以被向量化），再把後面的元素往後移一格
+ * - popMax：直接拿最後一個，O(1)
+ * - popMin：拿第一個，其他元素往前移一格，N 很小時只是一次很短的記憶體搬移
+ *
+ * 介面和 BasicMinMaxHeap、BasicDeap 相同。
+ */
+template<typename T, size_t N>
+class LinearDepq {
+public:
+    typedef T value_type;
+
+private:
+    /// 遞增排列
+    std::array<T, N> m_data;
+    size_t m_size = 0;
+
+public:
+    LinearDepq() = default;
+
+    /// @brief 從 [first, last) 建立
+    /// @throw std::length_error - 如果超過容量
+    template<typename InputIt>
+    LinearDepq(InputIt first, InputIt last) { pushRange(first, last); }
+
+    /// @brief 從初始化串列建立
+    /// @throw std::length_error - 如果超過容量
+    LinearDepq(std::initializer_list<value_type> list) : LinearDepq(list.begin(), list.end()) {}
+
+    /// @brief 插入 value
+    /// @throw std::length_error - 如果已經滿了
+    void push(value_type value) {
+        if (m_size == N) throw std::length_error("LinearDepq::push - capacity exceeded");
+
+        size_t pos = 0;
+        for (size_t i = 0; i < m_size; ++i) pos += !(value < m_data[i]);
+
+        std::move_backward(m_data.begin() + pos, m_data.begin() + m_size, m_data.begin() + m_size + 1);
+        m_data[pos] = std::move(value);
+        ++m_size;
+    }
+
+    /// @brief 一次插入 [first, last) 內的所有值
+    /// @throw std::length_error - 如果超過容量
+    template<typename InputIt>
+    void pushRange(InputIt first, InputIt last) {
+        for (; first != last; ++first) push(*first);
+    }
+
+    /// @brief 移除最小值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMin() {
+        if (m_size == 0) throw std::out_of_range("LinearDepq::popMin - no element");
+
+        value_type ret = std::move(m_data[0]);
+        std::move(m_data.begin() + 1, m_data.begin() + m_size, m_data.begin());
+        m_data[--m_size] = value_type();
+        return ret;
+    }
+
+    /// @brief 移除最大值並回傳
+    /// @throw std::out_of_range - 如果為空
+    value_type popMax() {
+        if (m_size == 0) throw std::out_of_range("LinearDepq::popMax - no element");
+
+        value_type ret = std::move(m_data[--m_size]);
+        m_data[m_size] = value_type();
+        return ret;
+    }
+
+    /// @brief 回傳最小值，不移除
+    /// @throw std::out_of_range - 如果為空
+    const value_type& peekMin() const {
+        if (m_size == 0) throw std::out_of_range("LinearDepq::peekMin - no element");
+        return m_data[0];
+    }
+
+    /// @brief 回傳最大值，不移除
+    /// @throw std::out_of_range - 如果為空
+    const value_type& peekMax() const {
+        if (m_size == 0) throw std::out_of_range("LinearDepq::peekMax - no element");
+        return m_data[m_size - 1];
+    }
+
+    /// 有幾個元素
+    size_t size() const { return m_size; }
+
+    /// @brief 回傳第 k 小的值
+    /// @throw std::out_of_range - 如果 k 為 0 或大於 size()
+    value_type kthSmallest(size_t k) const {
+        if (k == 0 || k > m_size) throw std::out_of_range("LinearDepq::kthSmallest - k out of range");
+        return m_data[k - 1];
+    }
+
+    /// @brief 回傳第 k 大的值
+    /// @throw std::out_of_range - 如果 k 為 0 或大於 size()
+    value_type kthLargest(size_t k) const {
+        if (k == 0 || k > m_size) throw std::out_of_range("LinearDepq::kthLargest - k out of range");
+        return m_data[m_size - k];
+    }
+
+    /// @brief 將所有元素排序後移到 out，呼叫後為空
+    /// @param out - 存放結果，原本的內容會被丟棄
+    /// @param ascending - `true`，由小到大；`false`，由大到小
+    void drainSorted(std::vector<value_type>& out, bool ascending = true) {
+        out.assign(std::make_move_iterator(m_data.begin()), std::make_move_iterator(m_data.begin() + m_size));
+        if (!ascending) std::reverse(out.begin(), out.end());
+
+        for (size_t i = 0; i < m_size; ++i) m_data[i] = value_type();
+        m_size = 0;
+    }
+};
+
+namespace StaticHeap_Trait {
+    /// 容量不超過這個值時，StaticMinMaxHeap 和 StaticDeap 改用 LinearDepq
+    constexpr size_t LINEAR_MAX = 16;
+}
+
+/// @brief 容量固定為 N、不需要配置記憶體的 Min-Max Heap。N 不超過 StaticHeap_Trait::LINEAR_MAX 時為 LinearDepq
+template<typename T, size_t N>
+using StaticMinMaxHeap = typename std::conditional<(N <= StaticHeap_Trait::LINEAR_MAX),
+    LinearDepq<T, N>, GenericMinMaxHeap<T, StaticVector<T, N>>>::type;
+
+/// @brief 容量固定為 N、不需要配置記憶體的Deap。N 不超過 StaticHeap_Trait::LINEAR_MAX 時為 LinearDepq
+template<typename T, size_t N>
+using StaticDeap = typename std::conditional<(N <= StaticHeap_Trait::LINEAR_MAX),
+    LinearDepq<T, N>, GenericDeap<T, StaticVector<T, N>>>::type;
+
+#endif // STATICHEAP_H
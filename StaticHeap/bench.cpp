@@ -0,0 +1,94 @@
+/**
+ * @file bench.cpp
+ * @brief 比較大量小型 heap 時，固定容量版本和 std::vector 版本的記憶體用量及 push、pop 速度
+ */
+#include "StaticHeap.h"
+#include "Benchmark.h"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+/// 透過 operator new 配置、還沒釋放的位元組數（不含配置器本身的額外開銷）
+static size_t g_allocated = 0;
+
+/// 每塊記憶體前面多配置一個 header 記錄大小，釋放時才知道要扣掉多少
+static const size_t HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    char* p = static_cast<char*>(malloc(size + HEADER));
+    if (p == nullptr) throw std::bad_alloc();
+
+    *reinterpret_cast<size_t*>(p) = size;
+    g_allocated += size;
+    return p + HEADER;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr == nullptr) return;
+
+    char* p = static_cast<char*>(ptr) - HEADER;
+    g_allocated -= *reinterpret_cast<size_t*>(p);
+    free(p);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+
+static const size_t INSTANCES = 100000;
+
+/// @brief 建立 INSTANCES 個 heap，每個 push fill 個值後交錯 popMin、popMax 直到清空
+template<typename Heap>
+static void bench(const std::string& name, size_t fill, const std::vector<int>& data)
+{
+    const size_t before = g_allocated;
+    std::unique_ptr<Heap[]> heaps(new Heap[INSTANCES]);
+    const size_t arrayBytes = g_allocated - before;
+
+    const double tPush = Benchmark::measure([&] {
+        for (size_t i = 0; i < INSTANCES; ++i) {
+            for (size_t j = 0; j < fill; ++j) heaps[i].push(data[(i + j * 7919) % data.size()]);
+        }
+    });
+    const size_t bytes = g_allocated - before;
+
+    const double tPop = Benchmark::measure([&] {
+        for (size_t i = 0; i < INSTANCES; ++i) {
+            for (size_t j = 0; j < fill; ++j) Benchmark::keep((j & 1) ? heaps[i].popMin() : heaps[i].popMax());
+        }
+    });
+
+    Benchmark::report((name + " push").c_str(), INSTANCES * fill, tPush);
+    Benchmark::report((name + " pop").c_str(), INSTANCES * fill, tPop);
+    printf("%-52s %12.1f B/instance (sizeof %zu, allocated %.1f)\n", "",
+        double(bytes) / INSTANCES, sizeof(Heap), double(bytes - arrayBytes) / INSTANCES);
+}
+
+int main()
+{
+    std::mt19937 gen(12345);
+    std::vector<int> data(1 << 16);
+    for (int& v : data) v = int(gen());
+
+    for (size_t fill : {8, 16}) {
+        printf("== %zu instances, %zu values each ==\n", INSTANCES, fill);
+        bench<BasicMinMaxHeap<int>>("BasicMinMaxHeap", fill, data);
+        bench<BasicDeap<int>>("BasicDeap", fill, data);
+        bench<StaticMinMaxHeap<int, 16>>("StaticMinMaxHeap<16> (linear)", fill, data);
+        bench<StaticMinMaxHeap<int, 64>>("StaticMinMaxHeap<64>", fill, data);
+        bench<StaticDeap<int, 64>>("StaticDeap<64>", fill, data);
+    }
+
+    for (size_t fill : {32, 64}) {
+        printf("== %zu instances, %zu values each ==\n", INSTANCES, fill);
+        bench<BasicMinMaxHeap<int>>("BasicMinMaxHeap", fill, data);
+        bench<BasicDeap<int>>("BasicDeap", fill, data);
+        bench<StaticMinMaxHeap<int, 64>>("StaticMinMaxHeap<64>", fill, data);
+        bench<StaticDeap<int, 64>>("StaticDeap<64>", fill, data);
+        bench<LinearDepq<int, 64>>("LinearDepq<64>", fill, data);
+    }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "StaticHeap.h"
+#include "Depq.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static_assert(Depq_Trait::isDepq<StaticMinMaxHeap<int, 8>> && Depq_Trait::isDepq<StaticDeap<int, 8>>, "LinearDepq should satisfy the DEPQ interface");
+static_assert(Depq_Trait::isMigratable<StaticMinMaxHeap<int, 64>> && Depq_Trait::isMigratable<StaticDeap<int, 64>>, "static heaps should satisfy the DEPQ interface");
+
+namespace {
+    /// 隨機交錯 push、popMin、popMax，和排序好的 vector 比對
+    template<typename Heap>
+    void randomOperations(size_t capacity) {
+        Heap heap;
+        std::vector<int> model;
+
+        for (int i = 0; i < 20000; ++i) {
+            const int op = rand() % 5;
+            if ((op < 2 || model.empty()) && model.size() < capacity) {
+                const int v = rand() % 50;
+                heap.push(v);
+                model.insert(std::upper_bound(model.begin(), model.end(), v), v);
+            }
+            else if (op == 2 || model.size() == capacity) {
+                ASSERT_TRUE(heap.peekMin() == model.front());
+                ASSERT_TRUE(heap.popMin() == model.front());
+                model.erase(model.begin());
+            }
+            else {
+                ASSERT_TRUE(heap.peekMax() == model.back());
+                ASSERT_TRUE(heap.popMax() == model.back());
+                model.pop_back();
+            }
+            ASSERT_TRUE(heap.size() == model.size());
+        }
+    }
+}
+
+TEST(StaticHeap, select) {
+    // 小容量用 LinearDepq，大容量用固定容量的 heap
+    ASSERT_TRUE((std::is_same<StaticMinMaxHeap<int, 16>, LinearDepq<int, 16>>::value));
+    ASSERT_TRUE((std::is_same<StaticDeap<int, 8>, LinearDepq<int, 8>>::value));
+    ASSERT_TRUE((std::is_same<StaticMinMaxHeap<int, 64>, GenericMinMaxHeap<int, StaticVector<int, 64>>>::value));
+    ASSERT_TRUE((std::is_same<StaticDeap<int, 64>, GenericDeap<int, StaticVector<int, 64>>>::value));
+
+    // 元素存在物件內
+    ASSERT_TRUE(sizeof(StaticMinMaxHeap<int, 64>) >= 64 * sizeof(int));
+    ASSERT_TRUE(sizeof(StaticDeap<int, 16>) >= 16 * sizeof(int));
+}
+
+TEST(StaticHeap, randomOperations) {
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed;
+    srand(seed);
+
+    randomOperations<StaticMinMaxHeap<int, 1>>(1);
+    randomOperations<StaticMinMaxHeap<int, 16>>(16);
+    randomOperations<StaticMinMaxHeap<int, 64>>(64);
+    randomOperations<StaticDeap<int, 16>>(16);
+    randomOperations<StaticDeap<int, 64>>(64);
+}
+
+TEST(StaticHeap, capacity) {
+    StaticMinMaxHeap<int, 4> linear {3, 1, 2, 4};
+    ASSERT_THROW(linear.push(5), std::length_error);
+    ASSERT_TRUE(linear.popMax() == 4);
+    linear.push(5);
+    ASSERT_TRUE(linear.peekMax() == 5);
+
+    std::vector<int> vec(40);
+    for (size_t i = 0; i < vec.size(); ++i) vec[i] = int(i * 7 % 40);
+    ASSERT_THROW((StaticDeap<int, 32>(vec.begin(), vec.end())), std::length_error);
+
+    StaticDeap<int, 32> deap(vec.begin(), vec.begin() + 32);
+    ASSERT_TRUE(deap.verify());
+    ASSERT_THROW(deap.push(0), std::length_error);
+
+    StaticMinMaxHeap<int, 32> mmheap;
+    mmheap.pushRange(vec.begin(), vec.begin() + 20);
+    ASSERT_THROW(mmheap.pushRange(vec.begin(), vec.begin() + 20), std::length_error);
+
+    ASSERT_THROW((StaticMinMaxHeap<int, 4>().popMin()), std::out_of_range);
+    ASSERT_THROW((StaticMinMaxHeap<int, 64>().popMax()), std::out_of_range);
+}
+
+TEST(StaticHeap, drainSorted) {
+    std::vector<int> vec;
+    for (int i = 0; i < 30; ++i) vec.push_back(rand() % 10);
+    std::vector<int> sorted = vec, out;
+    std::sort(sorted.begin(), sorted.end());
+
+    StaticMinMaxHeap<int, 32> mmheap(vec.begin(), vec.end());
+    ASSERT_TRUE(mmheap.kthSmallest(3) == sorted[2]);
+    ASSERT_TRUE(mmheap.kthLargest(3) == sorted[27]);
+    mmheap.drainSorted(out);
+    ASSERT_TRUE(out == sorted);
+    ASSERT_TRUE(mmheap.size() == 0);
+
+    StaticDeap<int, 32> deap(vec.begin(), vec.end());
+    deap.drainSorted(out, false);
+    ASSERT_TRUE(std::equal(out.rbegin(), out.rend(), sorted.begin(), sorted.end()));
+    ASSERT_TRUE(deap.size() == 0);
+
+    LinearDepq<int, 16> linear(vec.begin(), vec.begin() + 16);
+    std::vector<int> expect(vec.begin(), vec.begin() + 16);
+    std::sort(expect.begin(), expect.end());
+    ASSERT_TRUE(linear.kthSmallest(2) == expect[1]);
+    ASSERT_TRUE(linear.kthLargest(2) == expect[14]);
+    linear.drainSorted(out, false);
+    ASSERT_TRUE(std::equal(out.rbegin(), out.rend(), expect.begin(), expect.end()));
+}
+
+TEST(StaticHeap, templateTest) {
+    StaticMinMaxHeap<std::string, 8> linear {"d", "a", "c"};
+    StaticDeap<std::string, 32> deap {"d", "a", "c"};
+    linear.push("e");
+    deap.push("e");
+
+    ASSERT_TRUE(linear.popMin() == "a" && deap.popMin() == "a");
+    ASSERT_TRUE(linear.popMax() == "e" && deap.popMax() == "e");
+    ASSERT_TRUE(linear.size() == 2 && deap.size() == 2);
+}
@@ -0,0 +1,277 @@
+/**
+ * @file TtlHeap.h
+ * @brief 元素會在一段時間後過期的 double-ended priority queue，用來求「最近 T 秒內」的最小值及最大值
+ */
+#ifndef TTLHEAP_H
+#define TTLHEAP_H
+
+#include "MinMaxHeap.h"
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 元素會在加入 ttl 時間後過期的 double-ended priority queue
+ * @tparam T - 元素的型別，需要支援 `<`、`>`、`==`
+ * @tparam Heap - 存放元素的 heap 樣板，例如 BasicMinMaxHeap 或 BasicDeap
+ * @details
+ * 時間的單位由使用者決定（秒、毫秒……），只要和 ttl 一致即可。時間為 t 的元素在 `now - t >= ttl` 時過期。
+ * 每個操作都要傳入目前的時間，而且不能比上一次傳入的時間早。
+ *
+ * # 移除過期的元素
+ * 1. 過期的元素不會馬上移除。每次操作先從每個 heap 的兩端各丟掉最多 purgeBudget 個過期元素，
+ *    peek 或 pop 時如果 heap 的某一端仍是過期的元素，再把它丟掉。
+ *    值隨時間遞增（計數器、時間戳記）時，過期元素都集中在最小端；只要每次操作之間過期的元素不超過 purgeBudget 個，
+ *    兩端就不會累積過期元素，所以 peek 和 pop 最多只需要丟掉 purgeBudget 個。
+ * 2. 不在兩端的過期元素則交給「漸進式整理」：當過期元素超過存放數量的一半時，把目前的 heap 移到 m_old，
+ *    之後每次操作最多從 m_old 搬 purgeBudget 個元素到新的 heap，搬的時候丟掉過期的。
+ *    整理期間，peek 和 pop 會同時看兩個 heap。
+ * 3. 一段時間沒有操作後，可能整個 heap 都過期了。所以每個 heap 都記錄其中最新的時間，最新的元素也過期時，
+ *    整個 heap 直接移到 m_dead，不再參與 peek 和 pop，之後每次操作最多丟掉 purgeBudget 個。
+ *
+ * 唯一需要在一次操作中丟掉超過 purgeBudget 個元素的情況，是兩次操作之間時間跳太多，一端過期了很多元素、
+ * 但同一個 heap 中仍有未過期的元素。這時答案取決於第一個未過期的元素，必須把前面的丟掉。
+ *
+ * 為了知道有多少過期元素，m_times 依時間記錄每個時間點還存放著幾個元素。
+ */
+template<typename T, template<typename> class Heap = BasicMinMaxHeap>
+class TtlHeap {
+public:
+    typedef T value_type;
+    typedef int64_t time_type;
+
+private:
+    /// heap 中存放的元素，依 (value, time) 比較大小。值一樣時，時間早的比較小，所以 popMin 會先拿走較舊的
+    struct Entry {
+        value_type value;
+        time_type time;
+
+        friend bool operator< (const Entry& a, const Entry& b) { return a.value < b.value || (a.value == b.value && a.time < b.time); }
+        friend bool operator> (const Entry& a, const Entry& b) { return b < a; }
+        friend bool operator<=(const Entry& a, const Entry& b) { return !(b < a); }
+        friend bool operator>=(const Entry& a, const Entry& b) { return !(a < b); }
+        friend bool operator==(const Entry& a, const Entry& b) { return a.value == b.value && a.time == b.time; }
+    };
+
+    time_type m_ttl;
+    size_t m_purgeBudget;
+    time_type m_now;
+
+    /// 新的元素都放這裡
+    Heap<Entry> m_heap;
+    /// 正在整理的舊 heap，不整理時為空
+    Heap<Entry> m_old;
+    /// m_heap、m_old 中最新的時間，heap 為空時沒有意義
+    time_type m_heapNewest;
+    time_type m_oldNewest;
+
+    /// 所有元素都過期的 heap，等著被逐步丟掉
+    std::vector<Heap<Entry>> m_dead;
+    /// m_dead 中有幾個元素
+    size_t m_deadCount = 0;
+
+    /// (時間, 存放中的數量)，依時間排序
+    std::deque<std::pair<time_type, size_t>> m_times;
+    /// m_times 中 [0, m_cursor) 的時間點已經過期
+    size_t m_cursor = 0;
+    /// 存放中的過期元素有幾個
+    size_t m_expiredCount = 0;
+
+public:
+    /// @brief 建立空的 TtlHeap
+    /// @param ttl - 元素加入後經過多久會過期
+    /// @param purgeBudget - 漸進式整理時，每次操作最多搬幾個元素
+    /// @throw std::invalid_argument - 如果 ttl 不是正數或 purgeBudget 為 0
+    explicit TtlHeap(time_type ttl, size_t purgeBudget = 4)
+        : m_ttl(ttl), m_purgeBudget(purgeBudget), m_now(std::numeric_limits<time_type>::min()),
+          m_heapNewest(m_now), m_oldNewest(m_now)
+    {
+        if (ttl <= 0)         throw std::invalid_argument("TtlHeap - ttl must be positive");
+        if (purgeBudget == 0) throw std::invalid_argument("TtlHeap - purgeBudget must be positive");
+    }
+
+    /// @brief 插入新的值
+    /// @param value - 新的值
+    /// @param now - 目前的時間，也是 value 的時間
+    void push(const value_type& value, time_type now) {
+        advance(now);
+
+        m_heap.push(Entry{ value, now });
+        m_heapNewest = now;
+        if (m_times.empty() || m_times.back().first != now) m_times.emplace_back(now, 0);
+        ++m_times.back().second;
+    }
+
+    /// @brief 回傳最小值，不移除
+    /// @param now - 目前的時間
+    /// @throw std::out_of_range - 如果沒有未過期的元素
+    const value_type& peekMin(time_type now) {
+        advance(now);
+        return minHeap("TtlHeap::peekMin - no element").peekMin().value;
+    }
+
+    /// @brief 回傳最大值，不移除
+    /// @param now - 目前的時間
+    /// @throw std::out_of_range - 如果沒有未過期的元素
+    const value_type& peekMax(time_type now) {
+        advance(now);
+        return maxHeap("TtlHeap::peekMax - no element").peekMax().value;
+    }
+
+    /// @brief 移除最小值並回傳
+    /// @param now - 目前的時間
+    /// @throw std::out_of_range - 如果沒有未過期的元素
+    value_type popMin(time_type now) {
+        advance(now);
+        Entry e = minHeap("TtlHeap::popMin - no element").popMin();
+        forget(e.time);
+        return std::move(e.value);
+    }
+
+    /// @brief 移除最大值並回傳
+    /// @param now - 目前的時間
+    /// @throw std::out_of_range - 如果沒有未過期的元素
+    value_type popMax(time_type now) {
+        advance(now);
+        Entry e = maxHeap("TtlHeap::popMax - no element").popMax();
+        forget(e.time);
+        return std::move(e.value);
+    }
+
+    /// @brief 沒有其他操作時，也可以呼叫這個函數推進時間，順便做一次漸進式整理
+    /// @param now - 目前的時間
+    void expire(time_type now) { advance(now); }
+
+    /// @brief 未過期的元素有幾個
+    /// @param now - 目前的時間
+    size_t size(time_type now) { advance(now); return stored() - m_expiredCount; }
+
+    /// 實際存放的元素有幾個（包含還沒被移除的過期元素）
+    size_t stored() const { return m_heap.size() + m_old.size() + m_deadCount; }
+
+private:
+    bool expired(const Entry& e) const { return m_now - e.time >= m_ttl; }
+
+    /// @brief 更新目前的時間，並做一次漸進式整理
+    void advance(time_type now) {
+        assert(now >= m_now);
+        m_now = now;
+
+        // 每個時間點只會被 m_cursor 經過一次，所以攤銷後是 O(1)
+        while (m_cursor < m_times.size() && m_now - m_times[m_cursor].first >= m_ttl) {
+            m_expiredCount += m_times[m_cursor].second;
+            ++m_cursor;
+        }
+
+        // 整個 heap 都過期時，不要在 peek、pop 中一次丟掉
+        if (m_old.size() != 0 && m_now - m_oldNewest >= m_ttl) bury(m_old);
+        if (m_heap.size() != 0 && m_now - m_heapNewest >= m_ttl) bury(m_heap);
+
+        trim(m_heap);
+        trim(m_old);
+        purgeStep();
+    }
+
+    /// @brief 從 heap 的兩端各丟掉最多 m_purgeBudget 個過期元素
+    void trim(Heap<Entry>& heap) {
+        for (size_t i = 0; i < m_purgeBudget && heap.size() != 0 && expired(heap.peekMin()); ++i) forget(heap.popMin().time);
+        for (size_t i = 0; i < m_purgeBudget && heap.size() != 0 && expired(heap.peekMax()); ++i) forget(heap.popMax().time);
+    }
+
+    /// @brief 把所有元素都過期的 heap 移到 m_dead
+    void bury(Heap<Entry>& heap) {
+        m_deadCount += heap.size();
+        m_dead.push_back(std::move(heap));
+        heap = Heap<Entry>();
+    }
+
+    /// @brief 時間為 time 的元素被移除了
+    void forget(time_type time) {
+        auto it = std::lower_bound(m_times.begin(), m_times.end(), time,
+            [](const std::pair<time_type, size_t>& p, time_type t) { return p.first < t; });
+        assert(it != m_times.end() && it->first == time && it->second > 0);
+
+        --it->second;
+        if (static_cast<size_t>(it - m_times.begin()) < m_cursor) --m_expiredCount;
+
+        // 清掉前面已經沒有元素的時間點
+        while (!m_times.empty() && m_times.front().second == 0) {
+            m_times.pop_front();
+            if (m_cursor > 0) --m_cursor;
+        }
+    }
+
+    /// @brief 漸進式整理，最多丟掉或搬 m_purgeBudget 個元素，先處理 m_dead
+    void purgeStep() {
+        size_t budget = m_purgeBudget;
+        while (budget != 0 && !m_dead.empty()) {
+            Heap<Entry>& dead = m_dead.back();
+            for (; budget != 0 && dead.size() != 0; --budget) {
+                forget(dead.popMin().time);
+                --m_deadCount;
+            }
+            if (dead.size() == 0) m_dead.pop_back();
+        }
+
+        // m_heap、m_old 中的過期元素超過一半時，開始整理
+        if (m_old.size() == 0 && (m_expiredCount - m_deadCount) * 2 > m_heap.size()) {
+            std::swap(m_heap, m_old);
+            m_oldNewest = m_heapNewest;
+        }
+
+        for (; budget != 0 && m_old.size() != 0; --budget) {
+            Entry e = m_old.popMin();
+            if (expired(e)) forget(e.time);
+            else {
+                m_heapNewest = m_heap.size() == 0 ? e.time : std::max(m_heapNewest, e.time);
+                m_heap.push(std::move(e));
+            }
+        }
+    }
+
+    /// @brief 丟掉 heap 最小端的過期元素
+    void discardMin(Heap<Entry>& heap) {
+        while (heap.size() != 0 && expired(heap.peekMin())) forget(heap.popMin().time);
+    }
+
+    /// @brief 丟掉 heap 最大端的過期元素
+    void discardMax(Heap<Entry>& heap) {
+        while (heap.size() != 0 && expired(heap.peekMax())) forget(heap.popMax().time);
+    }
+
+    /// @brief 回傳最小值所在的 heap（m_heap 或 m_old）
+    /// @param error - 沒有元素時丟出的例外訊息
+    Heap<Entry>& minHeap(const char* error) {
+        discardMin(m_heap);
+        discardMin(m_old);
+
+        if (m_old.size() == 0) {
+            if (m_heap.size() == 0) throw std::out_of_range(error);
+            return m_heap;
+        }
+        if (m_heap.size() == 0) return m_old;
+        return m_old.peekMin() < m_heap.peekMin() ? m_old : m_heap;
+    }
+
+    /// @brief 回傳最大值所在的 heap（m_heap 或 m_old）
+    /// @param error - 沒有元素時丟出的例外訊息
+    Heap<Entry>& maxHeap(const char* error) {
+        discardMax(m_heap);
+        discardMax(m_old);
+
+        if (m_old.size() == 0) {
+            if (m_heap.size() == 0) throw std::out_of_range(error);
+            return m_heap;
+        }
+        if (m_heap.size() == 0) return m_old;
+        return m_old.peekMax() > m_heap.peekMax() ? m_old : m_heap;
+    }
+};
+
+#endif // TTLHEAP_H
@@ -0,0 +1,165 @@
+#include "TtlHeap.h"
+#include "MinMaxHeap.h"
+#include "Deap.h"
+#include "Benchmark.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+typedef std::pair<int64_t, int> Item; ///< (時間, 值)
+
+/// 用 vector 模擬 TtlHeap：移除過期的元素
+static void expire(std::vector<Item>& items, int64_t now, int64_t ttl) {
+    items.erase(std::remove_if(items.begin(), items.end(), [&](const Item& it) { return now - it.first >= ttl; }),
+                items.end());
+}
+
+/// 用 vector 模擬 TtlHeap：回傳最小值或最大值的位置。值一樣時，時間早的比較小
+static std::vector<Item>::iterator bruteForce(std::vector<Item>& items, bool min) {
+    auto byValue = [](const Item& a, const Item& b) { return std::make_pair(a.second, a.first) < std::make_pair(b.second, b.first); };
+    return min ? std::min_element(items.begin(), items.end(), byValue)
+               : std::max_element(items.begin(), items.end(), byValue);
+}
+
+template<template<typename> class Heap>
+static void testRandom(int64_t ttl, size_t purgeBudget) {
+    TtlHeap<int, Heap> heap(ttl, purgeBudget);
+    std::vector<Item> items;
+    int64_t now = 0;
+
+    for (int i = 0; i < 3000; ++i) {
+        now += rand() % 3;
+        expire(items, now, ttl);
+
+        switch (rand() % 4) {
+        case 0: case 1: {
+            const int v = rand() % 100;
+            heap.push(v, now);
+            items.emplace_back(now, v);
+            break;
+        }
+        case 2: {
+            const bool min = rand() & 1;
+            auto it = bruteForce(items, min);
+            if (it == items.end()) {
+                ASSERT_THROW(min ? heap.popMin(now) : heap.popMax(now), std::out_of_range);
+            }
+            else {
+                ASSERT_TRUE((min ? heap.popMin(now) : heap.popMax(now)) == it->second);
+                items.erase(it);
+            }
+            break;
+        }
+        default: {
+            const bool min = rand() & 1;
+            auto it = bruteForce(items, min);
+            if (it == items.end())
+                ASSERT_THROW(min ? heap.peekMin(now) : heap.peekMax(now), std::out_of_range);
+            else
+                ASSERT_TRUE((min ? heap.peekMin(now) : heap.peekMax(now)) == it->second);
+        }
+        }
+
+        ASSERT_TRUE(heap.size(now) == items.size());
+    }
+}
+
+TEST(TtlHeap, invalidArgument) {
+    ASSERT_THROW(TtlHeap<int>(0), std::invalid_argument);
+    ASSERT_THROW(TtlHeap<int>(10, 0), std::invalid_argument);
+}
+
+TEST(TtlHeap, expire) {
+    TtlHeap<int> heap(10);
+    heap.push(5, 0);
+    heap.push(1, 3);
+    heap.push(9, 6);
+
+    ASSERT_TRUE(heap.peekMin(9) == 1);
+    ASSERT_TRUE(heap.peekMax(9) == 9);
+    ASSERT_TRUE(heap.size(9) == 3);
+
+    // 5 在時間 10 過期
+    ASSERT_TRUE(heap.size(10) == 2);
+    ASSERT_TRUE(heap.popMax(10) == 9);
+    // 1 在時間 13 過期
+    ASSERT_TRUE(heap.peekMin(12) == 1);
+    ASSERT_THROW(heap.peekMin(13), std::out_of_range);
+    ASSERT_TRUE(heap.size(13) == 0);
+}
+
+TEST(TtlHeap, randomMinMaxHeap) {
+    unsigned seed = time(NULL);
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+
+    for (int64_t ttl : {1, 5, 50, 1000})
+        for (size_t budget : {1, 4})
+            testRandom<BasicMinMaxHeap>(ttl, budget);
+}
+
+TEST(TtlHeap, randomDeap) {
+    unsigned seed = rand();
+    std::cerr << "Random seed = " << seed << '\n';
+    srand(seed);
+
+    for (int64_t ttl : {1, 5, 50, 1000})
+        for (size_t budget : {1, 4})
+            testRandom<BasicDeap>(ttl, budget);
+}
+
+TEST(TtlHeap, purge) {
+    // 只 push 不 pop，過期元素大多不在兩端，要靠漸進式整理才能移除
+    TtlHeap<int> heap(100, 2);
+    size_t maxStored = 0;
+
+    for (int64_t now = 0; now < 100000; ++now) {
+        heap.push(rand(), now);
+        maxStored = std::max(maxStored, heap.stored());
+    }
+
+    ASSERT_TRUE(heap.size(100000 - 1) == 100);
+    // 過期元素超過一半才開始整理，整理期間每次搬 2 個，所以最多存放約 4 倍的未過期元素
+    ASSERT_TRUE(maxStored <= 400) << "maxStored = " << maxStored;
+}
+
+TEST(TtlHeap, quietPeriod) {
+    // 一段時間沒有操作後所有元素都過期，不能在一次操作中全部丟掉
+    TtlHeap<int> heap(1000, 4);
+    const size_t n = 50000;
+    for (size_t i = 0; i < n; ++i) heap.push(static_cast<int>((i * 7919) % n), static_cast<int64_t>(i / 50));
+
+    ASSERT_THROW(heap.peekMin(5000), std::out_of_range);
+    ASSERT_THROW(heap.popMax(5000), std::out_of_range);
+    ASSERT_TRUE(heap.stored() >= n - 8);
+    ASSERT_TRUE(heap.size(5000) == 0);
+
+    // 之後的操作不受還沒丟掉的元素影響，每次操作最多丟掉 4 個（每一輪有 4 次操作）
+    for (int64_t now = 5000; heap.stored() != 0; ++now) {
+        const size_t before = heap.stored();
+        heap.push(static_cast<int>(now), now);
+        ASSERT_TRUE(heap.peekMin(now) == now && heap.peekMax(now) == now);
+        ASSERT_TRUE(heap.popMin(now) == now);
+        ASSERT_TRUE(before - heap.stored() <= 4 * 4);
+    }
+}
+
+TEST(TtlHeap, monotone) {
+    // 值隨時間遞增時，過期元素都在最小端，而且不會觸發整理，不能累積到 popMin 時才一次丟掉
+    typedef Benchmark::Counted Counted;
+    TtlHeap<Counted> heap(1000, 4);
+    size_t maxComparisons = 0;
+    for (int now = 0; now < 100000; ++now) {
+        Counted::comparisons = 0;
+        heap.push(Counted{ now }, now);
+        maxComparisons = std::max(maxComparisons, Counted::comparisons);
+    }
+
+    Counted::comparisons = 0;
+    ASSERT_TRUE(heap.popMin(100000).value == 100000 - 1000 + 1);
+    maxComparisons = std::max(maxComparisons, Counted::comparisons);
+    // 每次操作最多丟掉 purgeBudget 個，每個 O(log n)，沒有限制時一次 popMin 會丟掉上千個
+    ASSERT_TRUE(maxComparisons <= 400) << "maxComparisons = " << maxComparisons;
+    ASSERT_TRUE(heap.stored() <= 1000 + 8);
+}